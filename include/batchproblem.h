@@ -0,0 +1,64 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <IOHprofiler_problem.h>
+#include <IOHprofiler_csv_logger.h>
+#include "span.h"
+
+class Solution;
+class ThreadPool;
+
+// Problem whose objective may be called from several threads at once.
+// IOHprofiler_problem::evaluate updates counters and the best-so-far and is
+// not thread-safe, so a batch is evaluated in two steps: the objective values
+// are computed in parallel, and every solution is then evaluated through
+// evaluate, serially and in index order. Right before its evaluate call a
+// solution's value is handed over together with its position, and
+// internal_evaluate throws if it is asked for any other position.
+class BatchProblem : public IOHprofiler_problem<double> {
+	private:
+		double const* handedX; // Position of the handed over value, NULL if there is none
+		double handedY;
+	protected:
+		virtual double objective(ConstSpan const x) const = 0; // Must be thread-safe
+	public:
+		BatchProblem();
+		virtual ~BatchProblem();
+		double internal_evaluate(std::vector<double> const& x);
+		std::vector<double> objectives(std::vector<Solution*> const& solutions, ThreadPool& pool) const;
+		void handOver(ConstSpan const x, double const y); // The value of the next evaluation, which must be of x
+};
+
+// BatchProblem of a problem of an IOHprofiler suite. Suite problems are not thread-safe, so it
+// loads one copy of the problem per evaluation thread, and every objective value is computed by
+// an idle copy. It takes the id, instance, name, bounds and optimum of the suite problem but no
+// problem type, so IOH does not transform the values of the copies a second time.
+class SuiteBatchProblem : public BatchProblem {
+	private:
+		std::vector<std::shared_ptr<IOHprofiler_problem<double>>> copies;
+		mutable std::vector<IOHprofiler_problem<double>*> idle;
+		mutable std::mutex mutex;
+		mutable std::condition_variable released; // A copy became idle
+	protected:
+		double objective(ConstSpan const x) const;
+	public:
+		SuiteBatchProblem(std::string const suiteName, int const problemId, int const instance, int const dimension,
+			int const threads);
+};
+
+// Loads a problem of an IOHprofiler suite, as a SuiteBatchProblem if it is evaluated on more than one thread
+std::shared_ptr<IOHprofiler_problem<double>> loadSuiteProblem(std::string const suiteName, int const problemId,
+	int const instance, int const dimension, int const evaluationThreads = 1);
+
+// Whether the objective values of the problem can be computed in parallel, that is,
+// whether it is a BatchProblem. Warns once per process if it cannot.
+bool isBatchProblem(std::shared_ptr<IOHprofiler_problem<double> > const problem);
+
+// Evaluates all unevaluated solutions. Objective values of a BatchProblem are
+// computed on the pool; other problems are evaluated serially, with a warning.
+// The problem and logger always see the evaluations in index order.
+void evaluateBatch(std::vector<Solution*> const& solutions, std::shared_ptr<IOHprofiler_problem<double> > const problem,
+	std::shared_ptr<IOHprofiler_csv_logger> const logger, ThreadPool& pool);
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+template <typename T>
+class IOHprofiler_problem;
+
+// Binary run state: a magic number, the format version and the kind of run, then the values in the
+// order the run wrote them, in the byte order of the machine. Vectors are stored with their length.
+// A checkpoint is written to a temporary file that only replaces the previous one once complete.
+class CheckpointWriter {
+	private:
+		std::string const path;
+		std::ofstream out;
+	public:
+		CheckpointWriter(std::string const path, std::string const kind);
+		template <typename T>
+		void write(T const value){
+			out.write(reinterpret_cast<char const*>(&value), sizeof(T));
+		}
+		template <typename T>
+		void write(std::vector<T> const& values){
+			write<uint64_t>(values.size());
+			out.write(reinterpret_cast<char const*>(values.data()), values.size() * sizeof(T));
+		}
+		void write(std::string const& s);
+		void commit(); // Replaces the previous checkpoint, throws std::runtime_error if writing failed
+};
+
+class CheckpointReader {
+	private:
+		std::string const path;
+		std::ifstream in;
+		void check();
+	public:
+		CheckpointReader(std::string const path, std::string const kind); // Throws std::runtime_error if the file is no checkpoint of this kind
+		template <typename T>
+		void read(T& value){
+			in.read(reinterpret_cast<char*>(&value), sizeof(T));
+			check();
+		}
+		template <typename T>
+		void read(std::vector<T>& values){
+			uint64_t size;
+			read(size);
+			values.resize(size);
+			in.read(reinterpret_cast<char*>(values.data()), size * sizeof(T));
+			check();
+		}
+		template <typename T>
+		void readInPlace(std::vector<T>& values){ // Keeps the buffer, so pointers into it stay valid
+			expect(values.size(), "vector length");
+			in.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(T));
+			check();
+		}
+		void read(std::string& s);
+		void expect(int64_t const value, std::string const what); // Throws std::runtime_error if the next value differs
+};
+
+struct CheckpointSettings {
+	CheckpointSettings(): path(""), interval(0){}
+	CheckpointSettings(std::string const path, int const interval): path(path), interval(interval){}
+
+	std::string path;
+	int interval; // Iterations between checkpoints, 0 disables checkpointing
+};
+
+// Checkpoints of one run. The run resumes from the checkpoint at the path if there is one, and removes
+// it once complete. The IOHprofiler problem of a resumed run counts from zero again (its loggers also
+// start over), so evaluations() adds those done before: budget and progress stay those of the original.
+// Next to the state the run saves, a checkpoint holds the seed of the rng, the problem, the evaluations
+// and the rng state. A run only resumes from a checkpoint taken with the same seed and problem.
+class RunCheckpoint {
+	private:
+		CheckpointSettings const settings;
+		std::string const kind;
+		std::shared_ptr<IOHprofiler_problem<double>> const problem;
+		int const popSize;
+		int const evalBudget;
+		int evaluationOffset; // Evaluations before the resume
+		int resumedIteration;
+		void writeRun(CheckpointWriter& writer) const;
+		void expectRun(CheckpointReader& reader) const;
+	public:
+		RunCheckpoint(CheckpointSettings const settings, std::string const kind,
+			std::shared_ptr<IOHprofiler_problem<double>> const problem, int const popSize, int const evalBudget);
+		bool exists() const; // Whether the run resumes; it should then skip its initial evaluations
+		int evaluations() const;
+		bool due(int const iteration) const;
+		void save(int const iteration, std::function<void(CheckpointWriter&)> const state) const;
+		int load(std::function<void(CheckpointReader&)> const state); // Returns the iteration to continue with
+		void finish() const;
+};
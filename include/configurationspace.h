@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// A configuration as the index of its operator in every component. Names are read from the space,
+// so decoding and filtering configurations copies no strings.
+class Configuration {
+	private:
+		std::vector<std::vector<std::string>> const* components;
+		std::vector<int> ids;
+		friend class ConfigurationSpace;
+	public:
+		Configuration(std::vector<std::vector<std::string>> const& components);
+		int size() const;
+		int id(int const component) const;
+		std::string const& operator[](int const component) const;
+		std::vector<std::string> names() const;
+};
+
+// Cartesian product of a number of components, each a list of operator names. Configuration i is
+// decoded from the mixed-radix digits of i, with the last component varying fastest, so an
+// unfiltered space of any size takes only the memory of its operator names. Filtered spaces
+// index the configurations that pass, which are listed on first use; that takes at most INT_MAX
+// configurations. Sampling draws every component independently and rejects what the filters do
+// not pass, so it works on spaces of any size. Only if 1000 draws in a row are rejected does it
+// list the passing configurations, as size() does, to draw from those.
+class ConfigurationSpace {
+	public:
+		typedef std::function<bool(Configuration const&)> Filter; // Reads the names through the configuration
+	private:
+		std::vector<std::vector<std::string>> components;
+		std::vector<Filter> filters;
+		mutable std::vector<int64_t> accepted; // Full-space indices passing the filters, if listed
+		mutable bool listed;
+
+		int64_t fullSize() const; // Throws std::overflow_error if it does not fit
+		void decode(int64_t index, Configuration& configuration) const;
+		bool accepts(Configuration const& configuration) const;
+		void list() const;
+	public:
+		ConfigurationSpace(int const components);
+		void setComponent(int const component, std::vector<std::string> const values);
+		void addFilter(Filter const filter);
+
+		int size() const; // Number of configurations passing the filters, throws std::overflow_error above INT_MAX
+		std::vector<std::string> get(int const i) const;
+		std::vector<std::string> sample() const; // Uniformly among the configurations passing the filters
+};
@@ -4,23 +4,56 @@
 #include <set>
 #include <map>
 #include <functional>
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "simd.h"
+#include "span.h"
 
 class Solution;
 class Particle;
+class CheckpointWriter;
+class CheckpointReader;
 
 class ConstraintHandler {
 	protected:
 		std::vector<double> const lb;
 		std::vector<double> const ub;
 		int const D;
-		int nCorrected;
+		VectorKernels const* const kernels; // For chunks of min(D, 64) coordinates: specialized if D <= 64
+		std::atomic<int> nCorrected; // Repairs may run on several threads
 		bool isFeasible(Solution const * const p) const;
+
+		// Calls fix(i) for every coordinate of x outside [lower, upper], in increasing order, and
+		// returns how many there were. The bounds are compared 64 coordinates at a time into a
+		// violation bitmap, so feasible coordinates cost no branches.
+		template <typename Fix>
+		int forEachViolation(double const* const x, double const* const lower, double const* const upper, Fix fix) const {
+			int count = 0;
+			for (int start = 0; start < D; start += 64){
+				int const n = std::min(64, D - start);
+				uint64_t bits = kernels->boundViolations(x + start, lower + start, upper + start, n);
+				count += __builtin_popcountll(bits);
+				for (; bits != 0; bits &= bits - 1)
+					fix(start + __builtin_ctzll(bits));
+			}
+			return count;
+		}
 	public:
-		ConstraintHandler(std::vector<double> const lb, std::vector<double> const ub): lb(lb), ub(ub), D(lb.size()), nCorrected(0){};
+		ConstraintHandler(std::vector<double> const lb, std::vector<double> const ub)
+			: lb(lb), ub(ub), D(lb.size()), kernels(getVectorKernels(std::min(D, 64))), nCorrected(0){};
 		virtual ~ConstraintHandler(){};
 		virtual bool resample(Solution* const p, int const resamples);
+		virtual bool resamplesDimensions() const {return false;}; // Only redraw the infeasible coordinates when resampling
+		// Resampling per coordinate: writes the infeasible coordinates of x to lanes (room for D) and returns how
+		// many there are, after resamples redraws of redrawn coordinates in total. Returns 0 once x is final.
+		virtual int coordinatesToRedraw(double* const x, int const resamples, int const redrawn, int* const lanes){return 0;};
+		virtual std::vector<int> takeResampleHistogram(){return {};}; // Solutions per number of resamples since the last call
 		virtual void penalize(Solution* const p){};
 		int getCorrections() const;
+		void save(CheckpointWriter& writer) const; // The number of corrections
+		void load(CheckpointReader& reader);
 };
 
 class DEConstraintHandler : virtual public ConstraintHandler {
@@ -29,6 +62,7 @@ class DEConstraintHandler : virtual public ConstraintHandler {
 		virtual ~DEConstraintHandler(){};
 		virtual void repairDE(Solution* const p, Solution const * const base, Solution const* const target){}; // DE constraint handler
 		virtual void repair(Solution* const p){};// Generic constraint handler
+		virtual void repairBatch(std::vector<Solution*> const& solutions); // Generic repair of a whole population
 };
 
 class PSOConstraintHandler : virtual public ConstraintHandler {
@@ -42,5 +76,24 @@ class PSOConstraintHandler : virtual public ConstraintHandler {
 		virtual void repair(Particle* const p){}; // Generic constraint handler
 };
 
+// Redraws the infeasible coordinates of x until the handler finds it final: redraw(lanes) writes new values at
+// the listed coordinates only, and nothing else of x is touched. Repair is the handler's type, or one that
+// forwards to it.
+template <typename Repair, typename Redraw>
+void redrawViolations(Repair& repair, double* const x, int* const lanes, Redraw redraw){
+	int redrawn = 0;
+	for (int resamples = 0; ; resamples++){
+		int const n = repair.coordinatesToRedraw(x, resamples, redrawn, lanes);
+		if (n == 0)
+			return;
+		redraw(Lanes(lanes, n));
+		redrawn += n;
+	}
+}
+
+// Keys the suites leave out of their default lists, so that adding a handler does not renumber the
+// configurations of existing sweeps. They can still be chosen with setConstraintHandlers().
+extern std::set<std::string> const optInCHs;
+
 extern std::map<std::string, std::function<DEConstraintHandler* (std::vector<double>, std::vector<double>)>> const deCHs;
 extern std::map<std::string, std::function<PSOConstraintHandler* (std::vector<double>, std::vector<double>)>> const psoCHs;
@@ -2,39 +2,69 @@
 #include <random>
 #include <stdexcept>
 #include <vector>
+#include <cstdint>
 #include<algorithm>
 #include "rng.h"
 #include "particle.h"
+#include "span.h"
+#include "simd.h"
 
 class CrossoverManager {
 	protected:
 		int const D;
+		VectorKernels const* const kernels; // Specialized for D if possible
+		mutable std::vector<double> x; // Scratch buffer for trial vectors
 	public:
 		CrossoverManager(int const D);
 		virtual ~CrossoverManager();
 
 		std::vector<Solution*> crossover(std::vector<Solution*>const& genomes, std::vector<Solution*>const& mutants, std::vector<double>const& Crs) const;
+		// Writes the trials in place. By default every pair goes through singleCrossover.
+		virtual void crossover(std::vector<Solution*>const& genomes, std::vector<Solution*>const& mutants, std::vector<double>const& Crs, std::vector<Solution*>const& trials) const;
 
-		virtual std::vector<double> singleCrossover(std::vector<double>const& target, 
-			std::vector<double>const& donor, double const Cr) const =0;
+		virtual void singleCrossover(ConstSpan const target, 
+			ConstSpan const donor, double const Cr, std::vector<double>& x) const =0;
 };
 
 extern std::map<std::string, std::function<CrossoverManager* (int const)>> const crossovers;
 
-class BinomialCrossoverManager : public CrossoverManager {
+// Crossovers that take every coordinate from either the target or the donor.
+// The choices are bit masks, which are generated for the whole population
+// first; the target and donor rows are then blended straight into the trials.
+class MaskCrossoverManager : public CrossoverManager {
+	protected:
+		int const words; // 64-bit words per mask
+		mutable std::vector<uint64_t> masks; // One row per trial
+		virtual void createMask(double const Cr, uint64_t* const mask) const=0; // Bit j set: coordinate j from the donor
 	public:
-		BinomialCrossoverManager(int const D): CrossoverManager(D){};
-		std::vector<double> singleCrossover(std::vector<double>const& target, std::vector<double>const& donor, double const Cr) const;
+		MaskCrossoverManager(int const D): CrossoverManager(D), words((D + 63) / 64), masks(words){};
+		void crossover(std::vector<Solution*>const& genomes, std::vector<Solution*>const& mutants, std::vector<double>const& Crs, std::vector<Solution*>const& trials) const;
+		void singleCrossover(ConstSpan const target, ConstSpan const donor, double const Cr, std::vector<double>& x) const;
 };
 
-class ExponentialCrossoverManager : public CrossoverManager {
+class BinomialCrossoverManager : public MaskCrossoverManager {
+	private:
+		void createMask(double const Cr, uint64_t* const mask) const;
 	public:
-		ExponentialCrossoverManager(int const D): CrossoverManager(D){};
-		std::vector<double> singleCrossover(std::vector<double>const& target, std::vector<double>const& donor, double const Cr) const;
+		BinomialCrossoverManager(int const D): MaskCrossoverManager(D){};
+};
+
+class ExponentialCrossoverManager : public MaskCrossoverManager {
+	private:
+		void createMask(double const Cr, uint64_t* const mask) const;
+	public:
+		ExponentialCrossoverManager(int const D): MaskCrossoverManager(D){};
 };
 
 class ArithmeticCrossoverManager : public CrossoverManager {
 	public:
 		ArithmeticCrossoverManager(int const D): CrossoverManager(D){};
-		std::vector<double> singleCrossover(std::vector<double>const& target, std::vector<double>const& donor, double const Cr) const;
+		void crossover(std::vector<Solution*>const& genomes, std::vector<Solution*>const& mutants, std::vector<double>const& Crs, std::vector<Solution*>const& trials) const;
+		void singleCrossover(ConstSpan const target, ConstSpan const donor, double const Cr, std::vector<double>& x) const;
 };
+
+// Calls X(key, type) for every crossover, see DE_MUTATIONS
+#define DE_CROSSOVERS(X) \
+	X(B, BinomialCrossoverManager) \
+	X(E, ExponentialCrossoverManager) \
+	X(A, ArithmeticCrossoverManager)
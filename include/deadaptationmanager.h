@@ -6,54 +6,62 @@
 #include <functional>
 #include <stdexcept>
 
+class CheckpointWriter;
+class CheckpointReader;
+
 class DEAdaptationManager {
 protected:
 	int const popSize;
+	std::vector<double> improvement; // Fitness gain of each trial over its target, 0 if it did not succeed
 public:
 	DEAdaptationManager(int const popSize); 
 	virtual ~DEAdaptationManager(){};
 	virtual void nextF(std::vector<double>& Fs)=0;
 	virtual void nextCr(std::vector<double>& Crs)=0;
-	virtual void update(std::vector<double>const& targets, std::vector<double>const& trials)=0;
+	void recordTrial(int const i, double const targetF, double const trialF){ // Once per individual and generation
+		improvement[i] = trialF < targetF ? targetF - trialF : 0.;
+	}
+	bool succeeded(int const i) const { // Whether the last recorded trial of individual i beat its target
+		return improvement[i] > 0.;
+	}
+	// Adapts to the recorded trials in one pass, given the parameters they were generated with
+	virtual void update(std::vector<double>const& Fs, std::vector<double>const& Crs)=0;
+	virtual void save(CheckpointWriter& writer) const; // The adapted parameters, between two generations
+	virtual void load(CheckpointReader& reader);
 };
 
 extern std::map<std::string, std::function<DEAdaptationManager*(int const)>> const deAdaptations;
 
 class JADEManager : public DEAdaptationManager{
 private:
-	std::vector<double> previousFs;
-	std::vector<double> previousCrs;
-
 	double MuCr;
 	double MuF;
 	double const c;
-	double lehmerMean(std::vector<double>const& SF) const;
+	std::vector<int> order; // Individuals, partially shuffled to pick those with uniform F
 public:
 	JADEManager(int const popSize);
 	void nextF(std::vector<double>& Fs);
 	void nextCr(std::vector<double>& Crs);
-	void update(std::vector<double>const& orig, std::vector<double>const& trials);
+	void update(std::vector<double>const& Fs, std::vector<double>const& Crs);
+	void save(CheckpointWriter& writer) const;
+	void load(CheckpointReader& reader);
 };
 
 class SHADEManager : public DEAdaptationManager {
 	private:
-		std::vector<double> previousFs;
-		std::vector<double> previousCrs;
-
 		int const H;
 		std::vector<double> MCr;
 		std::vector<double> MF;
 		std::vector<int> r;
 
 		int k;
-		double weightedLehmerMean(std::vector<double>const& x, std::vector<double>const& w) const;
-		double weightedMean(std::vector<double>const& x, std::vector<double>const& w) const;
-		std::vector<double> w(std::vector<double>const& delta) const;
 	public:
 		SHADEManager(int const popSize);
 		void nextF(std::vector<double>& Fs);
 		void nextCr(std::vector<double>& Crs);
-		void update(std::vector<double>const& orig, std::vector<double>const& trials);
+		void update(std::vector<double>const& Fs, std::vector<double>const& Crs);
+		void save(CheckpointWriter& writer) const;
+		void load(CheckpointReader& reader);
 };
 
 class NoAdaptationManager : public DEAdaptationManager {
@@ -64,5 +72,5 @@ public:
 	NoAdaptationManager(int const popSize);
 	void nextF(std::vector<double>& Fs);
 	void nextCr(std::vector<double>& Crs);
-	void update(std::vector<double>const& orig, std::vector<double>const& trials);
+	void update(std::vector<double>const& Fs, std::vector<double>const& Crs);
 };
@@ -0,0 +1,37 @@
+#pragma once
+#include <map>
+#include <string>
+#include <functional>
+#include <memory>
+#include "differentialevolution.h"
+#include "checkpoint.h"
+
+struct DEGeneration;
+
+// A DE run. Setting up, checkpointing and logging are the same for every configuration; the
+// generations are done by a DEEngine<Mutation, Crossover, Repair> (see deengine.cc), which the
+// registry holds for every mutation, crossover and constraint handler. Inside a generation the
+// per-individual calls to the mutation, the repair and the adaptation are direct calls, not
+// virtual ones. The adaptation is still chosen at runtime, as it is only called through its base
+// class once per generation, and the vector kernels are called through the table of the run's D.
+class DERunner {
+	protected:
+		DEConfig const config;
+		std::string const idString;
+		bool const useArena;
+		int const evaluationThreads;
+		CheckpointSettings const checkpointSettings;
+		virtual MutationManager* createMutation(int const D, DEConstraintHandler* const deCH) const=0;
+		virtual CrossoverManager* createCrossover(int const D) const=0;
+		virtual void generation(DEGeneration& state) const=0; // Mutation, crossover, evaluation and selection
+	public:
+		DERunner(DEConfig const config, std::string const idString, bool const useArena, int const evaluationThreads,
+				CheckpointSettings const checkpointSettings);
+		virtual ~DERunner(){};
+		void run(std::shared_ptr<IOHprofiler_problem<double> > const problem,
+			std::shared_ptr<IOHprofiler_csv_logger> const logger,
+			int const evalBudget, int const popSize) const;
+};
+
+// Keyed by mutation + "_" + crossover + "_" + constraint handler
+extern std::map<std::string, std::function<DERunner* (DEConfig const, std::string const, bool const, int const, CheckpointSettings const)>> const deEngines;
@@ -6,21 +6,20 @@
 #include "mutationmanager.h"
 #include "crossovermanager.h"
 #include "deadaptationmanager.h"
+#include "configurationspace.h"
 
 class DESuite {
 	private:		
-		std::vector<std::string> mutationManagers;
-		std::vector<std::string> crossoverManagers;
-		std::vector<std::string> adaptationManagers;
-		std::vector<std::string> constraintHandlers;
-		std::vector<DEConfig> configurations;
+		ConfigurationSpace space; // Mutation, crossover, adaptation, constraint handler
+		DifferentialEvolution create(std::vector<std::string> const& names) const;
 	public:
 		DESuite();
-		void generateConfigurations();
 		void setMutationManagers(std::vector<std::string> mutationManagers);
 		void setCrossoverManagers(std::vector<std::string> crossoverManagers);
 		void setDEAdaptationManagers(std::vector<std::string> adaptationManagers);
 		void setConstraintHandlers(std::vector<std::string> adaptationManagers);
+		void addFilter(ConfigurationSpace::Filter const filter); // Keeps the configurations it returns true for
 		DifferentialEvolution getDE(int const i);	
+		DifferentialEvolution getRandomDE();
 		int size() const;
 };
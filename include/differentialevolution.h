@@ -3,6 +3,7 @@
 #include "mutationmanager.h"
 #include "crossovermanager.h"
 #include "deadaptationmanager.h"
+#include "checkpoint.h"
 
 template <typename T>
 class IOHprofiler_problem;
@@ -19,8 +20,17 @@ struct DEConfig {
 class DifferentialEvolution {
 	private:
 		DEConfig const config;
+		bool useArena; // Reuse donor and trial buffers across generations
+		int evaluationThreads; // Evaluate trial populations in batches on this many threads if > 1 (BatchProblems only)
+		std::string logSuffix; // Appended to the names of the extra data files
+		CheckpointSettings checkpointSettings;
 	public:
 		DifferentialEvolution(DEConfig const config);
+		void setArena(bool const useArena);
+		void setEvaluationThreads(int const evaluationThreads);
+		void setLogSuffix(std::string const logSuffix); // E.g. to give every process its own files
+		// Saves the run state to path every interval generations, and resumes from it if it exists
+		void setCheckpoint(std::string const path, int const interval);
 		void run(std::shared_ptr<IOHprofiler_problem<double> > const problem, 
 			std::shared_ptr<IOHprofiler_csv_logger> const logger,
 			int const evalBudget, int const popSize) const;
@@ -0,0 +1,18 @@
+#pragma once
+#include <vector>
+#include "population.h"
+
+// Owns the donor and trial vectors of a DE population. Both buffers are
+// allocated once per run and overwritten every generation.
+class GenerationArena {
+	private:
+		Population donors;
+		Population trials;
+	public:
+		GenerationArena(int const size, int const D);
+		GenerationArena(GenerationArena const& other) = delete;
+		GenerationArena& operator=(GenerationArena const& other) = delete;
+
+		std::vector<Solution*> const& getDonors() const;
+		std::vector<Solution*> const& getTrials() const;
+};
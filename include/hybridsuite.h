@@ -8,23 +8,22 @@
 #include "topologymanager.h"
 #include "particleswarm.h"
 #include "hybridalgorithm.h"
+#include "configurationspace.h"
 
 template <typename T>
 class HybridSuite {
 	private:		
-		std::vector<std::string> updateManagers;
-		std::vector<std::string> topologyManagers;
-		std::vector<std::string> psoCHs;
-		std::vector<std::string> synchronicities;
-		std::vector<std::string> mutationManagers;
-		std::vector<std::string> crossoverManagers;
-		std::vector<std::string> selectionManagers;
-		std::vector<std::string> adaptationManagers;
-		std::vector<std::string> deCHs;
-		std::vector<HybridConfig> configurations;
+		// Mutation, crossover, update, topology, synchronicity, selection, adaptation, DE and PSO constraint handler
+		ConfigurationSpace space;
+
+		T create(std::vector<std::string> const& names) const {
+			return T(HybridConfig(names[2], names[3], names[8], names[4], names[0], names[1], names[5], names[6], names[7]));
+		}
 
 		public:
-		HybridSuite(){
+		HybridSuite() : space(9){
+			std::vector<std::string> updateManagers, topologyManagers, psoCHs, deCHs, mutationManagers, 
+				crossoverManagers, adaptationManagers;
 			for (auto&i : ::updateManagers)
 				updateManagers.push_back(i.first);
 
@@ -32,91 +31,79 @@ class HybridSuite {
 				topologyManagers.push_back(i.first);
 
 			for (auto&i : ::psoCHs)
-				psoCHs.push_back(i.first);
+				if (!optInCHs.count(i.first))
+					psoCHs.push_back(i.first);
 
 			for (auto&i : ::deCHs)
-				deCHs.push_back(i.first);
-
-			synchronicities.push_back("A");
-			synchronicities.push_back("S");
+				if (!optInCHs.count(i.first))
+					deCHs.push_back(i.first);
 
 			for (auto&i : ::mutations)
 				mutationManagers.push_back(i.first);
 			for (auto&i : ::crossovers)
 				crossoverManagers.push_back(i.first);
-			//for (auto&i : ::selections)
-				//selectionManagers.push_back(i.first);
 			for (auto&i : ::deAdaptations)
 				adaptationManagers.push_back(i.first);
 
-			generateConfigurations();
+			setMutationManagers(mutationManagers);
+			setCrossoverManagers(crossoverManagers);
+			setUpdateManagers(updateManagers);
+			setTopologyManagers(topologyManagers);
+			setSynchronicities({"A", "S"});
+			setSelectionManagers({""}); // Selection is only used by the deprecated PSODE
+			setDEAdaptationManagers(adaptationManagers);
+			setDEContraintHandlers(deCHs);
+			setPSOConstraintHandlers(psoCHs);
 		}
 
-		void generateConfigurations(){
-			configurations.clear();
-			for (auto mutation : mutationManagers)
-				for (auto crossover : crossoverManagers)
-					for (auto update : updateManagers)
-						for (auto topology : topologyManagers)
-							for (auto synchronicity : synchronicities)
-								for (auto selection : selectionManagers)
-									for (auto adaptation : adaptationManagers)
-										for (auto deCH : deCHs)
-											for (auto psoCH : psoCHs)
-												configurations.push_back(HybridConfig(update, topology, psoCH, synchronicity, mutation, 
-														crossover, selection, adaptation, deCH));
+		T getHybrid(int const i) {
+			return create(space.get(i));
+		}
 
+		T getRandomHybrid() {
+			return create(space.sample());
 		}
 
-		T getHybrid(int const i) {
-			return T(configurations[i]);
+		void addFilter(ConfigurationSpace::Filter const filter){ // Keeps the configurations it returns true for
+			space.addFilter(filter);
 		}
 
 		void setMutationManagers(std::vector<std::string> mutationManagers){
-			this->mutationManagers = mutationManagers;
-			generateConfigurations();
+			space.setComponent(0, mutationManagers);
 		}
 
 		void setCrossoverManagers(std::vector<std::string> crossoverManagers){
-			this->crossoverManagers = crossoverManagers;
-			generateConfigurations();
+			space.setComponent(1, crossoverManagers);
 		}
 
 		void setUpdateManagers(std::vector<std::string> updateManagers){
-			this->updateManagers = updateManagers;
-			generateConfigurations();
+			space.setComponent(2, updateManagers);
 		}
 
 		void setTopologyManagers(std::vector<std::string> topologyManagers){
-			this->topologyManagers = topologyManagers;
-			generateConfigurations();
+			space.setComponent(3, topologyManagers);
 		}
 
 		void setSynchronicities(std::vector<std::string> synchronicities){
-			this->synchronicities = synchronicities;
-			generateConfigurations();
+			space.setComponent(4, synchronicities);
 		}
 
 		void setSelectionManagers(std::vector<std::string> selectionManagers){
-			this->selectionManagers = selectionManagers;
-			generateConfigurations();
+			space.setComponent(5, selectionManagers);
 		}
 
 		void setDEAdaptationManagers(std::vector<std::string> adaptationManagers){
-			this->adaptationManagers = adaptationManagers;
-			generateConfigurations();
+			space.setComponent(6, adaptationManagers);
 		}
 		void setDEContraintHandlers(std::vector<std::string> deCHs){
-			this->deCHs = deCHs;
-			generateConfigurations();
+			space.setComponent(7, deCHs);
 		}
 
 		void setPSOConstraintHandlers(std::vector<std::string> psoCHs){
-			this->psoCHs = psoCHs;
-			generateConfigurations();
+			space.setComponent(8, psoCHs);
 		}
 
 		int size() const {
-			return configurations.size();
+			return space.size();
 		}
 };
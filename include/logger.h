@@ -28,7 +28,21 @@ class Logger { // Used to log arbitrary stuff
 				std::vector<double> const bestX, double const bestF, int const numEvals);
 
 		void log(std::vector<double> F, std::vector<double> Cr);
+		void log(std::vector<int> const& histogram);
 		void start(int const f, int const D);
 
 		void newLine();
 };
+
+class ResampleLogger { // Logs a resample histogram per generation; the file is only created if there is one
+	private:
+		std::string const filename;
+		int const function;
+		int const D;
+		Logger* logger;
+	public:
+		ResampleLogger(std::string filename, int const function, int const D)
+			: filename(filename), function(function), D(D), logger(NULL){};
+		~ResampleLogger();
+		void log(std::vector<int> const& histogram);
+};
@@ -8,26 +8,84 @@
 #include "rng.h"
 #include "util.h"
 
+class CheckpointWriter;
+class CheckpointReader;
+
 class MutationManager {
 	protected:
 		int const D;
+		VectorKernels const* const kernels; // Specialized for D if possible
 		DEConstraintHandler* const deCH;
 		std::vector<Solution*> genomes;
 		std::vector<double> Fs;
-		virtual Solution* mutate(int const i) const=0;
+		// Writes the mutant of genome i into m at the given coordinates, with newly drawn donors, and returns
+		// its base vector, for the DE repairs
+		virtual Solution const* mutate(int const i, Solution* const m, Lanes const lanes) const=0;
 		virtual void preMutation(){};
+		// Stores k <= 8 distinct random genomes other than genome i in xr, without copying the population
+		void pickDistinct(int const i, Solution** const xr, int const k) const;
+
+		std::vector<int> ranking; // Genome indices, best first, computed once per generation by rank()
+		void rank(bool const full); // If not full, only the top pBestCount genomes are placed first, unordered
+		Solution* getPBest() const; // Random genome of the top pBestCount of this generation
+
+		// The util functions of the same name, with the kernels of this manager. Only the given coordinates of
+		// store are written; a subset is computed one coordinate at a time, as the scalar kernels do.
+		void addScaledDifference(ConstSpan const a, ConstSpan const b, ConstSpan const c, double const F, double* const store,
+				Lanes const lanes) const {
+			if (lanes.all())
+				kernels->addScaledDifference(a.data(), b.data(), c.data(), F, store, D);
+			else
+				lanes.forEach(D, [&](int const j){store[j] = a[j] + (b[j] - c[j]) * F;});
+		}
+		void addScaledDifferences(ConstSpan const a, ConstSpan const b, ConstSpan const c, ConstSpan const d, ConstSpan const e,
+				double const F, double* const store, Lanes const lanes) const {
+			if (lanes.all())
+				kernels->addScaledDifferences(a.data(), b.data(), c.data(), d.data(), e.data(), F, store, D);
+			else
+				lanes.forEach(D, [&](int const j){store[j] = a[j] + (((b[j] - c[j]) + d[j]) - e[j]) * F;});
+		}
+		void addScaledDifferences(ConstSpan const a, ConstSpan const b, ConstSpan const c, ConstSpan const d, ConstSpan const e,
+				ConstSpan const f, ConstSpan const g, double const F, double* const store, Lanes const lanes) const {
+			if (lanes.all())
+				kernels->addScaledDifferences3(a.data(), b.data(), c.data(), d.data(), e.data(), f.data(), g.data(), F, store, D);
+			else
+				lanes.forEach(D, [&](int const j){store[j] = a[j] + (((((b[j] - c[j]) + d[j]) - e[j]) + f[j]) - g[j]) * F;});
+		}
 	public:
-		MutationManager(int const D, DEConstraintHandler * const deCH):D(D), deCH(deCH){};
+		MutationManager(int const D, DEConstraintHandler * const deCH):D(D), kernels(getVectorKernels(D)), deCH(deCH){};
 		virtual ~MutationManager(){};
+		void prepare(std::vector<Solution*>const& genomes, std::vector<double>const& Fs); // Start of a generation
 		std::vector<Solution*> mutate(std::vector<Solution*>const& genomes, std::vector<double>const& Fs);
+		void mutate(std::vector<Solution*>const& genomes, std::vector<double>const& Fs, std::vector<Solution*>const& mutants);
+		virtual void save(CheckpointWriter& writer) const {}; // State kept across generations, if any
+		virtual void load(CheckpointReader& reader){};
 };
 
 extern std::map<std::string, std::function<MutationManager* (int const, DEConstraintHandler* const)>> const mutations;
 
+// Mutates into m until the constraint handler accepts the mutant. mutate(m, lanes) writes a mutant into m at
+// the given coordinates and returns its base vector, which the DE repair gets along with the target. Handlers
+// that resample whole mutants rerun the mutation; with per-coordinate resampling, lanes has room for D
+// coordinates and only the infeasible ones are mutated again (see redrawViolations), otherwise it is NULL.
+template <typename Mutate, typename Repair>
+void mutateFeasible(Mutate mutate, Repair& repair, Solution* const m, Solution const* const target, int* const lanes){
+	if (lanes){
+		repair.repairDE(m, mutate(m, Lanes()), target);
+		redrawViolations(repair, m->modifyX(), lanes, [&](Lanes const redrawn){mutate(m, redrawn);});
+		return;
+	}
+
+	int resamples = 0;
+	do
+		repair.repairDE(m, mutate(m, Lanes()), target); // Resampling overwrites the rejected mutant
+	while (repair.resample(m, resamples++));
+}
+
 class Rand1MutationManager : public MutationManager {
 	public:
 		Rand1MutationManager(int const D, DEConstraintHandler* const deCH): MutationManager(D, deCH){};
-		Solution* mutate(int const i) const;
+		Solution const* mutate(int const i, Solution* const m, Lanes const lanes) const;
 };
 
 class TTB1MutationManager : public MutationManager {
@@ -36,7 +94,7 @@ class TTB1MutationManager : public MutationManager {
 		void preMutation();
 	public:
 		TTB1MutationManager(int const D, DEConstraintHandler* const deCH): MutationManager(D, deCH){};
-		Solution* mutate(int const i) const;
+		Solution const* mutate(int const i, Solution* const m, Lanes const lanes) const;
 };
 
 class TTB2MutationManager : public MutationManager {
@@ -45,13 +103,15 @@ class TTB2MutationManager : public MutationManager {
 		void preMutation();
 	public:
 		TTB2MutationManager(int const D, DEConstraintHandler* const deCH): MutationManager(D, deCH){};
-		Solution* mutate(int const i) const;
+		Solution const* mutate(int const i, Solution* const m, Lanes const lanes) const;
 };
 
 class TTPB1MutationManager : public MutationManager {
+	private:
+		void preMutation();
 	public:
 		TTPB1MutationManager(int const D, DEConstraintHandler* const deCH): MutationManager(D, deCH){};
-		Solution* mutate(int const i) const;
+		Solution const* mutate(int const i, Solution* const m, Lanes const lanes) const;
 };
 
 class Best1MutationManager: public MutationManager {
@@ -60,7 +120,7 @@ class Best1MutationManager: public MutationManager {
 		void preMutation();
 	public:
 		Best1MutationManager(int const D, DEConstraintHandler* const deCH):MutationManager(D, deCH){};
-		Solution* mutate(int const i) const;
+		Solution const* mutate(int const i, Solution* const m, Lanes const lanes) const;
 };
 
 class Best2MutationManager: public MutationManager {
@@ -69,65 +129,103 @@ class Best2MutationManager: public MutationManager {
 		void preMutation();
 	public:
 		Best2MutationManager(int const D, DEConstraintHandler* const deCH):MutationManager(D, deCH){};
-		Solution* mutate(int const i) const;
+		Solution const* mutate(int const i, Solution* const m, Lanes const lanes) const;
 };
 
 class Rand2MutationManager: public MutationManager {
 	public:
 		Rand2MutationManager(int const D, DEConstraintHandler* const deCH):MutationManager(D, deCH){};
-		Solution* mutate(int const i) const;
+		Solution const* mutate(int const i, Solution* const m, Lanes const lanes) const;
 };
 
 class Rand2DirMutationManager : public MutationManager {
 	public:
 		Rand2DirMutationManager(int const D, DEConstraintHandler* const deCH):MutationManager(D, deCH){};
-		Solution* mutate(int const i) const;
+		Solution const* mutate(int const i, Solution* const m, Lanes const lanes) const;
 };
 
 class NSDEMutationManager : public MutationManager {
 	public:
 		NSDEMutationManager(int const D, DEConstraintHandler* const deCH):MutationManager(D, deCH){};
-		Solution* mutate(int const i) const;
+		Solution const* mutate(int const i, Solution* const m, Lanes const lanes) const;
 };
 
 class TrigonometricMutationManager : public MutationManager {
 	private:
 		double const gamma;
-		Solution* trigonometricMutation(int const i) const;
-		Solution* rand1Mutation(int const i) const;
+		mutable std::vector<double> mutant;
+		mutable Solution base; // Base vector of the trigonometric mutation, only used for correction strategies
+		Solution const* trigonometricMutation(int const i, Solution* const m, Lanes const lanes) const;
+		Solution const* rand1Mutation(int const i, Solution* const m, Lanes const lanes) const;
 	public:
-		TrigonometricMutationManager(int const D, DEConstraintHandler* const deCH): MutationManager(D, deCH), gamma(0.05){};
-		Solution* mutate(int const i) const;
+		TrigonometricMutationManager(int const D, DEConstraintHandler* const deCH): MutationManager(D, deCH), gamma(0.05), mutant(D), base(D){};
+		Solution const* mutate(int const i, Solution* const m, Lanes const lanes) const;
 };
 
 class TwoOpt1MutationManager : public MutationManager {
 	public:
 		TwoOpt1MutationManager(int const D, DEConstraintHandler* const deCH): MutationManager(D, deCH) {};
-		Solution* mutate(int const i) const;
+		Solution const* mutate(int const i, Solution* const m, Lanes const lanes) const;
 };
 
 class TwoOpt2MutationManager : public MutationManager {
 	public:
 		TwoOpt2MutationManager(int const D, DEConstraintHandler* const deCH): MutationManager(D, deCH){};
-		Solution* mutate(int const i) const;
+		Solution const* mutate(int const i, Solution* const m, Lanes const lanes) const;
 };
 
+// Picks the donors of genome i with probability proportional to 1/distance to genome i.
+// Distances are only recomputed for genomes that changed since the last generation.
+// Memory stays quadratic in the population size, 1.5 NP^2 doubles against 2 NP^2 for dense distance
+// and probability matrices. The weights are packed, but the roulette of genome i runs over all NP
+// weights of row i, and those of the genomes before i lie in column i of the triangle, so every
+// row keeps a full Fenwick tree of its own.
 class ProximityMutationManager : public MutationManager {
 	private:
-		std::vector< std::vector<double> > Rp;
-		std::vector< std::vector<double> > Rd;
+		int size;
+		int generationsSinceRebuild;
+		std::vector<double> cachedX; // Positions at the last preMutation, to detect replaced genomes
+		std::vector<double> weights; // Packed strict upper triangle of 1/distance
+		std::vector<double> trees; // NP x NP: a Fenwick tree over the weights of every row
+		int packedIndex(int const i, int const j) const;
+		double weight(int const i, int const j) const;
+		void buildRow(int const row);
+		void addToRow(int const row, int const j, double const delta);
+		double prefix(int const row, int const j) const; // Sum of the weights before j
+		double rowTotal(int const row) const;
+		int findInRow(int const row, double target) const;
 		void preMutation();
 	public:
-		ProximityMutationManager(int const D, DEConstraintHandler* const deCH): MutationManager(D, deCH){};
-		Solution* mutate(int const i) const;
+		ProximityMutationManager(int const D, DEConstraintHandler* const deCH): MutationManager(D, deCH), size(0), generationsSinceRebuild(0){};
+		Solution const* mutate(int const i, Solution* const m, Lanes const lanes) const;
+		void save(CheckpointWriter& writer) const; // The trees carry rounding errors until the next rebuild
+		void load(CheckpointReader& reader);
 };
 
 class RankingMutationManager : public MutationManager {
 	private:
 		void preMutation();
-		std::map<Solution*, double> probability;
-		Solution* pickRanked(std::vector<Solution*> & possibilities) const;
+		std::vector<double> probability; // Selection probability of every genome, by index
+		int pickRanked(int const i) const;
 	public:
 		RankingMutationManager(int const D, DEConstraintHandler* const deCH): MutationManager(D, deCH){};
-		Solution* mutate(int const i) const;
+		Solution const* mutate(int const i, Solution* const m, Lanes const lanes) const;
 };
+
+// Calls X(key, type) for every mutation. The mutations registry and the DE engines are both built from
+// this list, so a key always creates the same type.
+#define DE_MUTATIONS(X) \
+	X(R1, Rand1MutationManager) \
+	X(T1, TTB1MutationManager) \
+	X(T2, TTB2MutationManager) \
+	X(P1, TTPB1MutationManager) \
+	X(B1, Best1MutationManager) \
+	X(B2, Best2MutationManager) \
+	X(R2, Rand2MutationManager) \
+	X(RD, Rand2DirMutationManager) \
+	X(NS, NSDEMutationManager) \
+	X(TR, TrigonometricMutationManager) \
+	X(O1, TwoOpt1MutationManager) \
+	X(O2, TwoOpt2MutationManager) \
+	X(PX, ProximityMutationManager) \
+	X(RA, RankingMutationManager)
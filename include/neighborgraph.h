@@ -0,0 +1,69 @@
+#pragma once
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+class Particle;
+class CheckpointWriter;
+class CheckpointReader;
+
+// Directed neighbor relation between the particles of a swarm, by index.
+// Every particle has a bitset row, so membership tests are O(1) and whole
+// rows can be rewired at once. Neighbors are enumerated straight from the
+// rows, so no neighbor lists are built, also not for dense topologies.
+// A particle is never its own neighbor.
+class NeighborGraph {
+	private:
+		int const size;
+		int const words; // 64-bit words per bitset row
+		std::vector<uint64_t> bits;
+
+		std::vector<int> collectRow(int const i, bool const set) const;
+	public:
+		NeighborGraph(int const size);
+		NeighborGraph(NeighborGraph const& other) = delete;
+		NeighborGraph& operator=(NeighborGraph const& other) = delete;
+
+		int getSize() const;
+		bool isNeighbor(int const i, int const j) const;
+		void addNeighbor(int const i, int const j); // Ignored if i == j
+		void removeNeighbor(int const i, int const j);
+		void removeAllNeighbors();
+		void connectAll(); // Every particle becomes a neighbor of every other particle
+
+		// Adds k random particles that are not yet neighbors of i
+		void addRandomNeighbors(int const i, int const k);
+		// Removes k random neighbors of i, except those for which keep returns true
+		void removeRandomNeighbors(int const i, int const k, std::function<bool(int const)> const& keep);
+
+		int getNumberOfNeighbors(int const i) const;
+		template <typename F>
+		void forEachNeighbor(int const i, F f) const { // Calls f(j) for every neighbor j of i, ascending
+			uint64_t const* const row = &bits[i * words];
+			for (int w = 0; w < words; w++){
+				for (uint64_t word = row[w]; word != 0; word &= word - 1)
+					f(w * 64 + __builtin_ctzll(word));
+			}
+		}
+
+		void save(CheckpointWriter& writer) const;
+		void load(CheckpointReader& reader);
+};
+
+// The neighbors of one particle: a row of a NeighborGraph, resolved to particles.
+class Neighborhood {
+	private:
+		NeighborGraph const* graph;
+		std::vector<Particle*> const* particles;
+		int index;
+	public:
+		Neighborhood();
+		Neighborhood(NeighborGraph const* const graph, std::vector<Particle*> const* const particles, int const index);
+		int size() const;
+		template <typename F>
+		void forEach(F f) const { // Calls f(particle) for every neighbor
+			if (graph != NULL)
+				graph->forEachNeighbor(index, [this, &f](int const j){f((*particles)[j]);});
+		}
+};
@@ -0,0 +1,32 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+class Population;
+class TopologyManager;
+class ThreadPool;
+class CheckpointWriter;
+class CheckpointReader;
+
+// Finds the best personal best in every neighborhood once per step, after all
+// personal bests were updated. With a static topology a neighborhood best can
+// only improve, so particles refer to the P row that holds it instead of
+// copying it; with the global topology this is a single argmin over the swarm.
+// Dynamic topologies may drop the holder from a neighborhood, so there the
+// position is copied into the particle's own g. Particle::updateGbest, used by
+// the asynchronous loop, applies the same rule to one particle, unless the run
+// reproduces earlier versions (ParticleSwarm::setLegacyGbest).
+class NeighborhoodBest {
+	private:
+		Population& population;
+		TopologyManager const& topology;
+		std::vector<int> holder; // Particle whose p is the neighborhood best, -1 if none yet
+		int globalHolder;
+		void updateGlobal();
+		void updateParticle(int const i);
+	public:
+		NeighborhoodBest(Population& population, TopologyManager const& topology);
+		void update(ThreadPool* const pool = NULL);
+		void save(CheckpointWriter& writer) const;
+		void load(CheckpointReader& reader);
+};
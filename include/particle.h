@@ -4,42 +4,57 @@
 #include "particleupdatesettings.h"
 #include "IOHprofiler_experimenter.h"
 #include "solution.h"
+#include "neighborgraph.h"
 
 class ParticleUpdateManager;
+class Population;
 
 class Particle : public Solution {
+	friend class Population; // Checkpoints the neighborhood best a particle follows
 	private:		
-		std::vector<double> v;
-		std::vector<double> p;		
-		std::vector<double> g;
+		std::vector<double> ownState; // v, p and g, only used when the particle is not a Population view
+		double ownPbest;
+		double ownGbest;
 
-		double pbest;
-		double gbest;
+		double* v;
+		double* p;		
+		double* g;
+		double const* best; // Neighborhood best position used by the update: g, or a row of P set by NeighborhoodBest
 
-		std::vector<Particle*> neighborhood;
+		double* pbest;
+		double* gbest;
+
+		std::vector<double> backup; // Position and velocity before a move, used when resampling
+		std::vector<int> lanes; // Infeasible coordinates when resampling per coordinate
+		Particle const* findBestNeighbor(); // Updates gbest with the own fitness and returns the best neighbor, or NULL
+
+		Neighborhood neighborhood; // Row of the topology's neighbor graph
 		ParticleUpdateManager* particleUpdateManager;
 		ParticleUpdateSettings const * const settings;
 		PSOConstraintHandler* const psoCH;
 	public:
 		Particle(int const D, ParticleUpdateSettings const*const particleUpdateSettings);
+		Particle(Population& population, int const i, ParticleUpdateSettings const*const particleUpdateSettings);
 		Particle(Particle const & other);
 		~Particle();
 		std::vector<double> getV() const;
+		ConstSpan getVView() const;
 		double getV(int const dim) const;
-		void setV(std::vector<double> const v);
+		void setV(std::vector<double> const& v);
 		void setV(int const dim, double val);
-		void setXandUpdateV(std::vector<double> const x, double const fitness); 
+		void setXandUpdateV(ConstSpan const x, double const fitness); 
 		double getGbest() const;
 		double getPbest() const;
 		std::vector<double> getG() const;
+		ConstSpan getGView() const;
 		std::vector<double> getP() const;
+		ConstSpan getPView() const;
 		double getP(int const i) const;
 		void updatePbest();
 		void updateGbest();
+		void followBest(double const* const position, double const value); // Refers to position instead of copying it
+		void copyBest(double const* const position, double const value);
 		void updateVelocityAndPosition(double const progress);
-		void addNeighbor(Particle* const neighbor);
-		void removeNeighbor(Particle* const neighbor);
-		void removeAllNeighbors();
-		bool isNeighbor(Particle* particle) const;
+		void setNeighborhood(Neighborhood const& neighborhood);
 		int getNumberOfNeighbors() const;
 };
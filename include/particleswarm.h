@@ -3,6 +3,7 @@
 #include <fstream>
 #include "particleupdatesettings.h"
 #include "topologymanager.h"
+#include "checkpoint.h"
 #include <memory>
 
 struct Problem;
@@ -22,6 +23,11 @@ struct PSOConfig {
 class ParticleSwarm {
 	private:
 		PSOConfig const config;
+		int threads; // Worker threads of the synchronous variant, 0 runs the plain serial loop
+		std::string logSuffix; // Appended to the names of the trajectory and extra data files
+		int trajectoryDecimation; // Iterations per recorded trajectory frame of the asynchronous variant, 0 records none
+		bool legacyGbest;
+		CheckpointSettings checkpointSettings;
 
 		void runSynchronous(std::shared_ptr<IOHprofiler_problem<double> > const problem, 
 			std::shared_ptr<IOHprofiler_csv_logger> const logger,
@@ -33,6 +39,15 @@ class ParticleSwarm {
 	public:
 		ParticleSwarm(PSOConfig const config);
 		~ParticleSwarm();
+		void setThreads(int const threads);
+		void setLogSuffix(std::string const logSuffix); // E.g. to give every thread or process its own files
+		void setTrajectoryDecimation(int const trajectoryDecimation);
+		// Reproduces the runs of earlier versions: a particle takes the neighborhood best of its best neighbor
+		// instead of that neighbor's personal best, and the serial synchronous loop updates the neighborhood
+		// bests particle by particle between the moves. Threaded synchronous runs are not affected.
+		void setLegacyGbest(bool const legacyGbest);
+		// Saves the run state to path every interval iterations, and resumes from it if it exists
+		void setCheckpoint(std::string const path, int const interval);
 
 		void run(std::shared_ptr<IOHprofiler_problem<double> > const problem, 
 			std::shared_ptr<IOHprofiler_csv_logger> const logger,
@@ -4,21 +4,20 @@
 #include "particleupdatemanager.h"
 #include "topologymanager.h"
 #include "particleswarm.h"
+#include "configurationspace.h"
 
 class ParticleSwarmSuite {
 	private:		
-		std::vector<std::string> updateManagers;
-		std::vector<std::string> topologyManagers;
-		std::vector<std::string> constraintHandlers;
-		std::vector<std::string> synchronicities;
-		std::vector<PSOConfig> configurations;
+		ConfigurationSpace space; // Update, topology, constraint handler, synchronicity
+		ParticleSwarm create(std::vector<std::string> const& names) const;
 	public:
 		ParticleSwarmSuite();
 		void setUpdateManagers(std::vector<std::string> updateManagers);
 		void setTopologyManagers(std::vector<std::string> topologyManagers);
 		void setSynchronicities(std::vector<std::string> synchronicities);
 		void setConstraintHandlers(std::vector<std::string> chs);
-		void generateConfigurations();
+		void addFilter(ConfigurationSpace::Filter const filter); // Keeps the configurations it returns true for
 		ParticleSwarm getParticleSwarm(int const i);	
+		ParticleSwarm getRandomParticleSwarm();
 		int size() const;
 };
@@ -3,33 +3,38 @@
 #include <map>
 #include <random>
 #include <functional>
+#include "span.h"
 
 class ConstraintHandler;
 struct ParticleUpdateSettings;
 class Particle;
+class Neighborhood;
+struct VectorKernels;
 
 class ParticleUpdateManager {
 	protected:
-		std::vector<double> & x;
-		std::vector<double> & v;
-		std::vector<double> const& p;
-		std::vector<double> const& g;
+		double* const x;
+		double* const v;
+		double const* const p;
+		double const* const& g; // The particle's neighborhood best, which may be another particle's p
 		int const D;
+		VectorKernels const* const kernels; // Specialized for D if possible
+		std::vector<double> r1; // Random coefficients of the cognitive and social terms
+		std::vector<double> r2;
+		// v = c*(w*v + r1*(p-x) + r2*(g-x)) at the given coordinates, with r1 drawn from [0, phi1) and r2 from [0, phi2)
+		void inertiaVelocity(double const phi1, double const phi2, double const w, double const c, Lanes const lanes);
 	public:
-		ParticleUpdateManager(std::vector<double>& x, std::vector<double>& v,
-			std::vector<double>const& p, std::vector<double>const& g);
+		ParticleUpdateManager(double* const x, double* const v,
+			double const* const p, double const* const& g, int const D);
 		virtual ~ParticleUpdateManager();
 
-		//This constructor is used for ParticleUpdateManagers that do not use a 
-		//velocity vector.
-		ParticleUpdateManager(std::vector<double>& x, std::vector<double> & p, std::vector<double>& g);
-
-		virtual void updateVelocity(double const progress);
-		virtual void updatePosition();
+		// Both only update the given coordinates, with newly drawn coefficients
+		virtual void updateVelocity(double const progress, Lanes const lanes);
+		virtual void updatePosition(Lanes const lanes);
 };
 
-extern std::map<std::string, std::function<ParticleUpdateManager* (std::vector<double>&, std::vector<double>&,
-		std::vector<double>const&, std::vector<double>const&, std::map<int,double>, std::vector<Particle*>&)>> const updateManagers;
+extern std::map<std::string, std::function<ParticleUpdateManager* (double* const, double* const,
+		double const* const, double const* const&, int const, std::map<int,double>, Neighborhood const&)>> const updateManagers;
 
 class InertiaWeightManager : public ParticleUpdateManager{
 	private:
@@ -38,9 +43,9 @@ class InertiaWeightManager : public ParticleUpdateManager{
 		double w;
 
 	public:
-		InertiaWeightManager(std::vector<double>& x, std::vector<double>& v,
-			std::vector<double>const& p, std::vector<double>const& g, std::map<int, double> paramaters, std::vector<Particle*>& neighborhood);
-		void updateVelocity(double const progress);
+		InertiaWeightManager(double* const x, double* const v,
+			double const* const p, double const* const& g, int const D, std::map<int, double> paramaters, Neighborhood const& neighborhood);
+		void updateVelocity(double const progress, Lanes const lanes);
 };
 
 class DecrInertiaWeightManager : public ParticleUpdateManager {
@@ -50,9 +55,9 @@ class DecrInertiaWeightManager : public ParticleUpdateManager {
 		double const wMin;
 		double const wMax;
 	public:
-		DecrInertiaWeightManager(std::vector<double>& x, std::vector<double>& v,
-			std::vector<double>const& p, std::vector<double>const& g, std::map<int, double> paramaters, std::vector<Particle*>& neighborhood);
-		void updateVelocity(double const progress);
+		DecrInertiaWeightManager(double* const x, double* const v,
+			double const* const p, double const* const& g, int const D, std::map<int, double> paramaters, Neighborhood const& neighborhood);
+		void updateVelocity(double const progress, Lanes const lanes);
 
 };
 
@@ -63,22 +68,24 @@ class ConstrictionCoefficientManager : public ParticleUpdateManager {
 		double const chi;
 	public: 
 
-		ConstrictionCoefficientManager(std::vector<double> & x, std::vector<double> & v,
-			std::vector<double>const& p, std::vector<double>const& g, std::map<int, double> paramaters, std::vector<Particle*>& neighborhood);
+		ConstrictionCoefficientManager(double* const x, double* const v,
+			double const* const p, double const* const& g, int const D, std::map<int, double> paramaters, Neighborhood const& neighborhood);
 
-		void updateVelocity(double const progress);
+		void updateVelocity(double const progress, Lanes const lanes);
 };
 
 class FIPSManager : public ParticleUpdateManager {
 	private:
 		double const phi;
 		double const chi;
-		std::vector<Particle*>& neighborhood;
+		Neighborhood const& neighborhood;
+		std::vector<double const*> neighborP; // Personal bests of the neighbors, read in place
+		std::vector<double> weights;
 	public:
-		FIPSManager(std::vector<double> & x, std::vector<double> & v,
-			std::vector<double>const& p, std::vector<double>const& g, 
-			std::map<int, double> paramaters, std::vector<Particle*>& neighborhood);
-		void updateVelocity(double const progress);
+		FIPSManager(double* const x, double* const v,
+			double const* const p, double const* const& g, int const D, 
+			std::map<int, double> paramaters, Neighborhood const& neighborhood);
+		void updateVelocity(double const progress, Lanes const lanes);
 };
 
 
@@ -87,9 +94,9 @@ class BareBonesManager : public ParticleUpdateManager {
 	private:
 		
 	public: 
-		BareBonesManager(std::vector<double> & x, std::vector<double> & v,
-			std::vector<double>const& p, std::vector<double>const& g, 
-			std::map<int, double> paramaters, std::vector<Particle*>& neighborhood);
-		void updatePosition();
-		void updateVelocity(double const progress);
+		BareBonesManager(double* const x, double* const v,
+			double const* const p, double const* const& g, int const D, 
+			std::map<int, double> paramaters, Neighborhood const& neighborhood);
+		void updatePosition(Lanes const lanes);
+		void updateVelocity(double const progress, Lanes const lanes);
 };
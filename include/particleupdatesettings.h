@@ -38,13 +38,15 @@ enum Setting {
 };
 
 struct ParticleUpdateSettings {
-	ParticleUpdateSettings(std::string const managerType, std::map<int, double> const parameters, PSOConstraintHandler*const psoCH)
-		:managerType(managerType), parameters(parameters), psoCH(psoCH){
+	ParticleUpdateSettings(std::string const managerType, std::map<int, double> const parameters, PSOConstraintHandler*const psoCH,
+			bool const legacyGbest = false)
+		:managerType(managerType), parameters(parameters), psoCH(psoCH), legacyGbest(legacyGbest){
 	};
 
-	ParticleUpdateSettings(){}
+	ParticleUpdateSettings(): legacyGbest(false){}
 
 	std::string managerType;
 	std::map<int, double> parameters;
 	PSOConstraintHandler* psoCH;
+	bool legacyGbest; // Particle::updateGbest takes the best neighbor's g instead of its p
 };
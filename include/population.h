@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+#include "solution.h"
+#include "particle.h"
+
+struct ParticleUpdateSettings;
+class CheckpointWriter;
+class CheckpointReader;
+
+// Stores positions, velocities, personal bests and fitness values of a whole
+// population as contiguous row-major (size x D) matrices. The Solutions and
+// Particles handed out by a Population are views on their row.
+class Population {
+	friend class Solution;
+	friend class Particle;
+	private:
+		std::vector<double> X; // Positions
+		std::vector<double> V; // Velocities
+		std::vector<double> P; // Personal best positions
+		std::vector<double> G; // Neighborhood best positions
+		std::vector<double> fitness;
+		std::vector<double> pbest;
+		std::vector<double> gbest;
+
+		std::vector<Solution> solutionViews;
+		std::vector<Particle> particleViews;
+		std::vector<Solution*> solutions;
+		std::vector<Particle*> particles;
+	public:
+		Population(int const size, int const D);
+		Population(int const size, int const D, ParticleUpdateSettings const*const settings);
+		Population(Population const& other) = delete;
+		Population& operator=(Population const& other) = delete;
+
+		int const size;
+		int const D;
+
+		double* getX(int const i);
+		double const* getX(int const i) const;
+		double* getV(int const i);
+		double const* getV(int const i) const;
+		double* getP(int const i);
+		double const* getP(int const i) const;
+		double* getG(int const i);
+		double const* getG(int const i) const;
+		double getFitness(int const i) const;
+		double getPbest(int const i) const;
+
+		Solution* getSolution(int const i) const;
+		Particle* getParticle(int const i) const;
+		std::vector<Solution*> const& getSolutions() const;
+		std::vector<Particle*> const& getParticles() const; // Empty unless constructed with update settings
+
+		void randomize(std::vector<double> const& lowerBounds, std::vector<double> const& upperBounds);
+		int getBestIndex() const;
+
+		// All rows, whether they are evaluated and which position each particle follows
+		void save(CheckpointWriter& writer) const;
+		void load(CheckpointReader& reader);
+};
@@ -6,6 +6,7 @@
 #include "crossovermanager.h"
 //#include "selectionmanager.h"
 #include "hybridalgorithm.h"
+#include "checkpoint.h"
 #include <memory>
 
 class PSODE2 : public HybridAlgorithm {
@@ -13,6 +14,9 @@ class PSODE2 : public HybridAlgorithm {
 		std::vector<Solution*> particles;		
 		std::vector<Particle*> psoPop;
 		std::vector<Solution*> dePop;
+		bool useArena; // Reuse donor and trial buffers across generations
+		bool legacyGbest;
+		CheckpointSettings checkpointSettings;
 
 		void runAsynchronous(std::shared_ptr<IOHprofiler_problem<double>> const problem, 
 			std::shared_ptr<IOHprofiler_csv_logger> const logger, int const evalBudget, 
@@ -22,6 +26,10 @@ class PSODE2 : public HybridAlgorithm {
 	public:
 		PSODE2(HybridConfig const config);
 		~PSODE2();
+		void setArena(bool const useArena);
+		void setLegacyGbest(bool const legacyGbest); // See ParticleSwarm::setLegacyGbest
+		// Saves the run state to path every interval iterations, and resumes from it if it exists
+		void setCheckpoint(std::string const path, int const interval);
 
 		void run(std::shared_ptr<IOHprofiler_problem<double> > const problem, 
 			std::shared_ptr<IOHprofiler_csv_logger> const logger, int const evalBudget, 
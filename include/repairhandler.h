@@ -1,6 +1,7 @@
 #pragma once
 #include <functional>
 #include <limits>
+#include <memory>
 #include <vector>
 #include "constrainthandler.h"
 #include <iostream>
@@ -57,10 +58,26 @@ class PBestDimRepair : public PSOConstraintHandler {
 
 // Generic
 class ResamplingRepair : public DEConstraintHandler, public PSOConstraintHandler  {
+	protected:
+		int const maxResamples; // Infeasible coordinates are projected after this many redraws
+		std::unique_ptr<std::atomic<int>[]> const histogram; // Solutions per number of resamples
 	public:
-		ResamplingRepair(std::vector<double> const lb, std::vector<double> const ub)
-			:ConstraintHandler(lb,ub), DEConstraintHandler(lb,ub), PSOConstraintHandler(lb, ub){};
+		ResamplingRepair(std::vector<double> const lb, std::vector<double> const ub, int const maxResamples=100);
 		bool resample(Solution * const p, int const resamples);
+		std::vector<int> takeResampleHistogram();
+};
+
+// Only redraws the infeasible coordinates: the mutation or particle move is evaluated at just those, with new
+// donors or coefficients. At most 2D coordinates are redrawn per solution, so resampling costs at most two more
+// mutations; the coordinates that are still infeasible then are projected.
+class DimensionResamplingRepair : public ResamplingRepair {
+	private:
+		int const budget; // Coordinates redrawn per solution at most
+	public:
+		DimensionResamplingRepair(std::vector<double> const lb, std::vector<double> const ub)
+			:ConstraintHandler(lb,ub), ResamplingRepair(lb, ub, 2 * lb.size()), budget(2 * lb.size()){};
+		bool resamplesDimensions() const {return true;};
+		int coordinatesToRedraw(double* const x, int const resamples, int const redrawn, int* const lanes);
 };
 
 class DeathPenalty : public DEConstraintHandler, public PSOConstraintHandler {
@@ -71,44 +88,80 @@ class DeathPenalty : public DEConstraintHandler, public PSOConstraintHandler {
 };
 
 class ReinitializationRepair : public DEConstraintHandler, public PSOConstraintHandler {
+	private:
+		bool repairRow(double* const x) const; // True if anything was repaired
 	public:
 		ReinitializationRepair(std::vector<double> const lb, std::vector<double> const ub)
 			:ConstraintHandler(lb,ub), DEConstraintHandler(lb, ub), PSOConstraintHandler(lb,ub){}; 
 		void repair(Solution* const p);
 		void repair(Particle* const p);
+		void repairBatch(std::vector<Solution*> const& solutions);
 };
 
 class ProjectionRepair : public DEConstraintHandler, public PSOConstraintHandler {
+	private:
+		bool repairRow(double* const x) const; // True if anything was repaired
 	public:
 		ProjectionRepair(std::vector<double> const lb, std::vector<double> const ub)
 			:ConstraintHandler(lb,ub), DEConstraintHandler(lb, ub), PSOConstraintHandler(lb,ub){};
 		void repair(Solution* const p);
 		void repair(Particle* const p);
+		void repairBatch(std::vector<Solution*> const& solutions);
 };
 
 class ReflectionRepair : public DEConstraintHandler, public PSOConstraintHandler {
+	private:
+		bool repairRow(double* const x) const; // True if anything was repaired
 	public:
 		ReflectionRepair(std::vector<double> const lb, std::vector<double> const ub)
 			:ConstraintHandler(lb,ub), DEConstraintHandler(lb, ub), PSOConstraintHandler(lb,ub){}; 
 		void repair(Solution* const p);
 		void repair(Particle* const p);
+		void repairBatch(std::vector<Solution*> const& solutions);
 };
 
 class WrappingRepair : public DEConstraintHandler, public PSOConstraintHandler {
+	private:
+		bool repairRow(double* const x) const; // True if anything was repaired
 	public:
 		WrappingRepair(std::vector<double> const lb, std::vector<double> const ub):ConstraintHandler(lb,ub), DEConstraintHandler(lb, ub), 
 		PSOConstraintHandler(lb,ub){}; 
 		void repair(Solution* const p);
 		void repair(Particle* const p);
+		void repairBatch(std::vector<Solution*> const& solutions);
 };
 
 class TransformationRepair : public DEConstraintHandler, public PSOConstraintHandler { //Adapted from https://github.com/psbiomech/c-cmaes
 	private:
 		std::vector<double> al, au, xlo, xhi, r;
-		bool shift(Solution* const p);
-		bool shift(Particle* const p);
+		std::vector<double> innerLb, innerUb; // Coordinates outside [lb+al, ub-au] are transformed
+		void transform(double* const x, int const i) const; // Shift into range, then transform coordinate i
+		bool repairRow(double* const x) const; // True if anything was repaired
 	public:
 		TransformationRepair(std::vector<double> const lb, std::vector<double> const ub);
 		void repair(Solution* const p);
 		void repair(Particle* const p);
+		void repairBatch(std::vector<Solution*> const& solutions);
 };
+
+// Calls X(key, type, hooks) for every DE constraint handler. The deCHs registry and the DE engines are both
+// built from this list. Hooks is the class that defines the resample, penalize and repairDE of the type,
+// which the engines call directly; DEConstraintHandler for handlers that only repair through repairBatch().
+#define DE_REPAIRS(X) \
+	/* Generic */ \
+	X(DP, DeathPenalty, DeathPenalty) \
+	X(RS, ResamplingRepair, ResamplingRepair) \
+	X(RC, DimensionResamplingRepair, DimensionResamplingRepair) \
+	/* Almost generic */ \
+	X(RI, ReinitializationRepair, DEConstraintHandler) \
+	X(PR, ProjectionRepair, DEConstraintHandler) \
+	X(RF, ReflectionRepair, DEConstraintHandler) \
+	X(WR, WrappingRepair, DEConstraintHandler) \
+	X(TR, TransformationRepair, DEConstraintHandler) \
+	/* DE */ \
+	X(RB, RandBaseRepair, RandBaseRepair) \
+	X(MB, MidpointBaseRepair, MidpointBaseRepair) \
+	X(MT, MidpointTargetRepair, MidpointTargetRepair) \
+	X(PM, ProjectionMidpointRepair, ProjectionMidpointRepair) \
+	X(PB, ProjectionBaseRepair, ProjectionBaseRepair) \
+	X(CO, ConservatismRepair, ConservatismRepair)
@@ -1,19 +1,60 @@
 #pragma once
 #include <random>
 #include <algorithm>
+#include <cstdint>
+
+class CheckpointWriter;
+class CheckpointReader;
+
+// Counter-based Philox4x32-10 generator. A (seed, stream) pair selects an
+// independent sequence, and the position in it is a plain block counter, so
+// any point of any stream can be reached without generating the numbers
+// before it.
 class RNG {
 	private:
-		std::random_device dev;
-		std::mt19937 rng;
-		std::bernoulli_distribution boolDist;
+		uint64_t key;
+		uint64_t stream;
+		uint64_t counter; // Next block to generate
+		uint32_t block[4];
+		int used; // Number of words of block already consumed
+		double spare; // Second value of the last Box-Muller pair
+		bool hasSpare;
+
+		void generateBlock();
+		uint32_t next32();
+		uint64_t next64();
+		double nextDouble(); // Uniform in [0,1)
+		double nextNormal(); // Standard normal
 	public:
-		RNG();
+		RNG(); // Seeded from std::random_device
+		RNG(uint64_t const seed, uint64_t const stream = 0);
+		void seed(uint64_t const seed, uint64_t const stream = 0);
+		void seek(uint64_t const stream, uint64_t const counter = 0);
+		uint64_t getSeed() const;
+		uint64_t nextSeed(); // Raw 64 bits, e.g. to derive streams for child work items
+		void save(CheckpointWriter& writer) const; // The complete state, including a pending normal value
+		void load(CheckpointReader& reader);
+
 		bool randBool();
 		double randDouble(double start, double end);
 		int randInt(int start, int end);
 		double normalDistribution(double mean, double stdDev);
 		double cauchyDistribution(double a, double b);
 		void shuffle(std::vector<double>::iterator first, std::vector<double>::iterator last);
+
+		// Bulk generation, cheaper than drawing the values one by one
+		void fillUniform(double* const out, int const n, double const start, double const end);
+		void fillNormal(double* const out, int const n, double const mean, double const stdDev);
+		void fillCauchy(double* const out, int const n, double const a, double const b);
+		// Truncated to (lower, inf). The normal rejects in batches: accepted values are packed to the
+		// front and only the rest is redrawn. The Cauchy inverts its CDF on the remaining interval and
+		// takes a location per value; a may alias out.
+		void fillTruncatedNormal(double* const out, int const n, double const mean, double const stdDev, double const lower);
+		void fillTruncatedCauchy(double* const out, int const n, double const* const a, double const b, double const lower);
+		// Sets each of the bits 0..n-1 with probability p and clears the rest of the last word.
+		// Rare outcomes are placed by geometric skips, common ones by comparing raw 32-bit draws.
+		void fillBernoulli(uint64_t* const bits, int const n, double const p);
+		int geometric(double const p, int const max); // Successes before the first failure, at most max
 };
 
-extern RNG rng;
\ No newline at end of file
+extern thread_local RNG rng; // Every thread draws from its own stream
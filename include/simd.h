@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+#include <cstdint>
+
+// Table of the vector kernels used in the inner loops of the mutation and
+// particle update managers. There is a scalar, an AVX2 and an AVX-512 table;
+// the widest one the CPU supports is selected at startup. All tables give
+// bit-identical results.
+struct VectorKernels {
+	char const* name;
+	void (*scale)(double* const x, double const a, int const D); // x = a*x
+	void (*add)(double const* const a, double const* const b, double* const out, int const D);
+	void (*subtract)(double const* const a, double const* const b, double* const out, int const D);
+	void (*multiply)(double* const x, double const* const r, int const D); // x = x*r elementwise
+	double (*squaredDistance)(double const* const a, double const* const b, int const D);
+	// out = a + F*(b-c)
+	void (*addScaledDifference)(double const* const a, double const* const b, double const* const c,
+		double const F, double* const out, int const D);
+	// out = a + F*(((b-c)+d)-e)
+	void (*addScaledDifferences)(double const* const a, double const* const b, double const* const c,
+		double const* const d, double const* const e, double const F, double* const out, int const D);
+	// out = a + F*(((((b-c)+d)-e)+f)-g)
+	void (*addScaledDifferences3)(double const* const a, double const* const b, double const* const c, double const* const d,
+		double const* const e, double const* const f, double const* const g, double const F, double* const out, int const D);
+	// Bit j set if x[j] < lb[j] or x[j] > ub[j], for D <= 64
+	uint64_t (*boundViolations)(double const* const x, double const* const lb, double const* const ub, int const D);
+	// out = bit j of mask ? b : a
+	void (*select)(double const* const a, double const* const b, uint64_t const* const mask, double* const out, int const D);
+	// v = c*(w*v + r1*(p-x) + r2*(g-x))
+	void (*updateVelocity)(double* const v, double const* const x, double const* const p, double const* const g,
+		double const* const r1, double const* const r2, double const w, double const c, int const D);
+	// v = c*(v + (sum_k phi[k]*(p[k]-x))/n), summed over k in order, in one pass over the n rows p[k]
+	void (*fullyInformedVelocity)(double* const v, double const* const x, double const* const* const p,
+		double const* const phi, int const n, double const c, int const D);
+};
+
+// Selected table for vectors of length D. For the BBOB dimensions 2, 5, 10, 20,
+// 40 and 100 this is a table specialized for D, which must then only be called
+// with that D; otherwise it is a table for any D. The managers look up their
+// table once, when they are created for a run.
+VectorKernels const* getVectorKernels(int const D);
+
+// Selects "scalar", "avx2" or "avx512" for the runs started afterwards. Returns false if the CPU does not support it.
+bool setVectorKernels(std::string const isa);
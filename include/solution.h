@@ -1,24 +1,42 @@
 #pragma once
 #include <vector>
 #include <IOHprofiler_experimenter.h>
+#include "span.h"
 
+class Population;
+
+// A Solution either owns its position or is a view on a row of a Population.
+// Copying a view yields another view on the same row.
 class Solution {
+	private:
+		std::vector<double> ownX; // Only used when the solution is not a Population view
+		double ownFitness;
+		void take(std::vector<double>&& x);
 	protected:
-		std::vector<double> x;
+		double* x;
+		double* fitness;
 		bool evaluated;
-		double fitness;
 	public:
 		Solution(int const D);
+		Solution(Population& population, int const i);
+		Solution(Solution const& other);
 		virtual ~Solution();
-		Solution(std::vector<double> const mutant);
+		Solution(std::vector<double> const& mutant);
+		Solution(std::vector<double>&& mutant);
 		int const D;
-		virtual void setX(std::vector<double> const x, double const fitness);
+		virtual void setX(std::vector<double> const& x, double const fitness);
+		virtual void setX(std::vector<double>&& x, double const fitness);
+		void setX(ConstSpan const x, double const fitness);
 		void setX(int const dim, double const val);
-		void setX(std::vector<double> x);
+		void setX(std::vector<double> const& x);
+		void setX(std::vector<double>&& x);
 		std::vector<double> getX() const;
+		ConstSpan getXView() const;
+		double* modifyX(); // Position for in-place writes; marks the solution as unevaluated
 		double getX(int const dim) const;
 		double evaluate (std::shared_ptr<IOHprofiler_problem<double> > problem, std::shared_ptr<IOHprofiler_csv_logger> logger);
 		double getFitness() const;
+		bool isEvaluated() const;
 		void setFitness(double const d);
 		std::string positionString() const;
 		void randomize(std::vector<double> const lowerBounds, std::vector<double> const upperBounds);
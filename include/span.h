@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Read-only, non-owning view on D contiguous doubles.
+class ConstSpan {
+	private:
+		double const* first;
+		int length;
+	public:
+		ConstSpan(double const* const first, int const length): first(first), length(length){};
+		ConstSpan(std::vector<double> const& vec): first(vec.data()), length(vec.size()){};
+		double operator[](int const i) const {return first[i];};
+		double const* data() const {return first;};
+		double const* begin() const {return first;};
+		double const* end() const {return first + length;};
+		int size() const {return length;};
+};
+
+// The coordinates an update is evaluated at: all D of them, or the count listed in index.
+// Resampling per coordinate only evaluates the update at the infeasible ones.
+class Lanes {
+	private:
+		int const* index; // NULL for all coordinates
+		int count;
+	public:
+		Lanes(): index(NULL), count(0){};
+		Lanes(int const* const index, int const count): index(index), count(count){};
+		bool all() const {return index == NULL;};
+		int size(int const D) const {return index ? count : D;};
+		template <typename F>
+		void forEach(int const D, F f) const { // Calls f(j) for every coordinate j, in order
+			if (!index)
+				for (int j = 0; j < D; j++)
+					f(j);
+			else
+				for (int k = 0; k < count; k++)
+					f(index[k]);
+		}
+};
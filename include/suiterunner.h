@@ -0,0 +1,68 @@
+#pragma once
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "desuite.h"
+#include "particleswarmsuite.h"
+#include "hybridsuite.h"
+
+template <typename T>
+class IOHprofiler_problem;
+class IOHprofiler_csv_logger;
+class IOHprofiler_configuration;
+
+// Runs the (configuration, problem, instance, dimension, run) tasks of a sweep concurrently on one node.
+// Problems, instances and dimensions are read from an IOHprofiler configuration file. Every task gets
+// its own problem instance and rng stream, so the results do not depend on the number of threads,
+// and every thread logs to its own folders and files. Threads take the tasks in order, so a thread
+// is done with a configuration once it moves on: only its current logger is kept open.
+class SuiteRunner {
+	public:
+		typedef std::shared_ptr<IOHprofiler_problem<double>> Problem;
+		typedef std::shared_ptr<IOHprofiler_csv_logger> CsvLogger;
+		// Runs one configuration. Files the algorithm writes itself must carry the log suffix.
+		typedef std::function<void(Problem const, CsvLogger const, std::string const logSuffix)> Job;
+	private:
+		std::string const configFile;
+		int const threads;
+		int const evaluationThreads; // Per task; DE evaluates its trial populations on this many threads if > 1
+		std::vector<std::string> names;
+		std::vector<Job> jobs;
+
+		std::mutex mutex;
+		std::map<std::thread::id, int> threadSlots;
+		std::map<int, std::pair<int, CsvLogger>> loggers; // Per thread slot: the configuration it logs, and its logger
+		int getThreadSlot();
+		CsvLogger getLogger(IOHprofiler_configuration const& conf, int const configuration, int const slot);
+		static std::vector<int> all(int const size, std::vector<int> const& configurations);
+	public:
+		SuiteRunner(std::string const configFile, int const threads, int const evaluationThreads = 1);
+		SuiteRunner(SuiteRunner const& other) = delete;
+		SuiteRunner& operator=(SuiteRunner const& other) = delete;
+
+		void add(std::string const name, Job const job);
+
+		// Add all configurations of a suite, or only the listed ones. Every task calls
+		// run(algorithm, problem, logger) on its own copy of the configuration's algorithm.
+		void add(DESuite& suite, std::function<void(DifferentialEvolution&, Problem const, CsvLogger const)> const run,
+				std::vector<int> const configurations = {});
+		void add(ParticleSwarmSuite& suite, std::function<void(ParticleSwarm&, Problem const, CsvLogger const)> const run,
+				std::vector<int> const configurations = {});
+		template <typename T, typename Run>
+		void add(HybridSuite<T>& suite, Run const run, std::vector<int> const configurations = {}){
+			for (int const i : all(suite.size(), configurations)){
+				T const algorithm = suite.getHybrid(i);
+				add(algorithm.getIdString(), [=](Problem const problem, CsvLogger const logger, std::string const logSuffix){
+					T copy = algorithm;
+					run(copy, problem, logger);
+				});
+			}
+		}
+
+		void run(int const independentRuns); // The task streams are derived from the calling thread's rng
+		int size() const; // Number of configurations
+};
@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+// Fixed set of worker threads that execute parallel loops. The calling thread
+// takes part in every loop, so a pool of size 1 runs everything serially.
+class ThreadPool {
+	private:
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::condition_variable finished;
+		std::function<void(int const)> const* task;
+		std::atomic<int> next;
+		int n;
+		int active;
+		unsigned int generation;
+		bool stop;
+		std::exception_ptr error;
+
+		void work();
+		void workerLoop();
+	public:
+		ThreadPool(int const threads);
+		ThreadPool(ThreadPool const& other) = delete;
+		ThreadPool& operator=(ThreadPool const& other) = delete;
+		~ThreadPool();
+
+		int size() const;
+		// Calls f(i) for every i in [0,n) and returns when all calls are done.
+		// The first exception thrown by f is rethrown in the calling thread.
+		void parallelFor(int const n, std::function<void(int const)> const& f);
+		// Like parallelFor, but call i draws from its own rng stream, derived from the
+		// calling thread's rng. The results do not depend on the number of threads.
+		void parallelForStreams(int const n, std::function<void(int const)> const& f);
+};
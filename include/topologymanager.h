@@ -3,16 +3,27 @@
 #include<functional>
 #include<map>
 #include<random>
+#include "neighborgraph.h"
 
 class Particle;
+class CheckpointWriter;
+class CheckpointReader;
 
+// Topologies are built and rewired on the neighbor graph, by particle index.
+// The particles see their row of the graph through a Neighborhood.
 class TopologyManager {
 	protected:
 		std::vector<Particle*>const &particles;
+		NeighborGraph graph;
 	public:
 		TopologyManager(std::vector<Particle*> const & particles);
 		virtual ~TopologyManager();
 		virtual void update(double progress);
+		virtual bool isStatic() const; // The graph never changes after construction
+		virtual bool isGlobal() const; // Every particle is a neighbor of every other particle
+		NeighborGraph const& getGraph() const;
+		virtual void save(CheckpointWriter& writer) const; // The graph and the state of dynamic topologies
+		virtual void load(CheckpointReader& reader);
 };
 
 extern std::map<std::string, std::function<TopologyManager* (std::vector<Particle*> const&)>> const topologies;
@@ -25,6 +36,7 @@ class LbestTopologyManager : public TopologyManager {
 class GbestTopologyManager : public TopologyManager {
 	public:
 		GbestTopologyManager(std::vector<Particle*> const & particles);
+		bool isGlobal() const;
 };
 
 class RandomTopologyManager : public TopologyManager {
@@ -52,6 +64,9 @@ class IncreasingTopologyManager : public TopologyManager {
 	public:
 		IncreasingTopologyManager(std::vector<Particle*> const & particles);
 		void update(double progress);
+		bool isStatic() const;
+		void save(CheckpointWriter& writer) const;
+		void load(CheckpointReader& reader);
 };
 
 class DecreasingTopologyManager : public TopologyManager {
@@ -61,6 +76,9 @@ class DecreasingTopologyManager : public TopologyManager {
 	public:
 		DecreasingTopologyManager(std::vector<Particle*> const & particles);
 		void update(double progress);
+		bool isStatic() const;
+		void save(CheckpointWriter& writer) const;
+		void load(CheckpointReader& reader);
 };
 
 class MultiSwarmTopologyManager : public TopologyManager {
@@ -71,5 +89,8 @@ class MultiSwarmTopologyManager : public TopologyManager {
 	public:
 		MultiSwarmTopologyManager(std::vector<Particle*> const & particles);
 		void update(double progress);
+		bool isStatic() const;
+		void save(CheckpointWriter& writer) const;
+		void load(CheckpointReader& reader);
 };
 
@@ -0,0 +1,49 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Population;
+
+// Records the positions of a population in a binary file that can be memory-mapped. A 32-byte header
+// (magic "PSOTRAJ", version, population size, D, decimation, the iteration of the first frame and 4
+// reserved bytes, as uint32 values) is followed by one frame per recorded iteration: a row of D positions
+// and the fitness per individual, as float32. All values are in the byte order of the machine, so
+// little-endian on x86 and ARM. Frames have a fixed size, so frame k is at 32 + k * size * (D+1) * 4 bytes
+// and holds iteration first + k * decimation of the run.
+// A run resumed at firstIteration appends to the trajectory it left, cut back to the frames before
+// firstIteration; if that file is missing or shorter, a new one starts at the next recorded iteration.
+// A frame is converted by the caller and written by a separate thread; record() only waits if all
+// frames in flight are still queued.
+class TrajectoryWriter {
+	private:
+		static int const framesInFlight = 4;
+		int const size;
+		int const D;
+		int const decimation; // Iterations per recorded frame
+		int iteration; // Of the run
+		std::ofstream out;
+
+		std::vector<std::vector<float>> frames;
+		std::vector<int> idle; // Frames free to fill
+		std::deque<int> queued; // Frames to write, oldest first
+		bool stop;
+		std::mutex mutex;
+		std::condition_variable ready; // A frame was queued, or the writer must stop
+		std::condition_variable freed; // A frame was written
+		std::thread writer;
+		void writeLoop();
+	public:
+		TrajectoryWriter(std::string const filename, int const size, int const D, int const decimation,
+				int const firstIteration);
+		TrajectoryWriter(TrajectoryWriter const& other) = delete;
+		TrajectoryWriter& operator=(TrajectoryWriter const& other) = delete;
+		~TrajectoryWriter(); // Writes the queued frames
+
+		void record(Population const& population); // Once per iteration
+};
@@ -5,11 +5,21 @@
 #include <iostream>
 #include "rng.h"
 #include "particle.h"
+#include "span.h"
 
 void scale(std::vector<double>& vec, double const x);
-void add(std::vector<double>const& lhs, std::vector<double>const& rhs, std::vector<double>& store);
-void subtract(std::vector<double>const& lhs, std::vector<double>const& rhs, std::vector<double>& store);
+void add(ConstSpan const lhs, ConstSpan const rhs, std::vector<double>& store);
+void subtract(ConstSpan const lhs, ConstSpan const rhs, std::vector<double>& store);
 void randomMult(std::vector<double>& vec, double const min, double const max);
+void scale(double* const vec, double const x, int const D);
+void add(double const* const lhs, double const* const rhs, double* const store, int const D);
+void subtract(double const* const lhs, double const* const rhs, double* const store, int const D);
+void randomMult(double* const vec, double const min, double const max, int const D);
+void addScaledDifference(ConstSpan const a, ConstSpan const b, ConstSpan const c, double const F, double* const store); // a + F*(b-c)
+void addScaledDifferences(ConstSpan const a, ConstSpan const b, ConstSpan const c, ConstSpan const d, ConstSpan const e,
+	double const F, double* const store); // a + F*(b-c+d-e)
+void addScaledDifferences(ConstSpan const a, ConstSpan const b, ConstSpan const c, ConstSpan const d, ConstSpan const e,
+	ConstSpan const f, ConstSpan const g, double const F, double* const store); // a + F*(b-c+d-e+f-g)
 bool comparePtrs(Solution const* const a, Solution const* const b);
 double distance(Solution const*const s1, Solution const*const s2);
 std::string generateConfig(std::string const templateFile, std::string const name);
@@ -21,17 +31,19 @@ void sortOnFitness(std::vector<T*>& genomes){
 	std::sort(genomes.begin(), genomes.end(), comparePtrs);
 }
 
-template<typename T>
-T* getPBest(std::vector<T*> genomes){
-	double const p = std::max(0.05, 3./genomes.size());
+// Size of the top p fraction that pbest is sampled from, at least the best genome
+inline int pBestCount(int const size){
+	double const p = std::max(0.05, 3./size);
 	//double const p = 0.1;
+	return std::max(1, int(size * p));
+}
 
-	sortOnFitness(genomes);
-	std::vector<T*> bestP = std::vector<T*>(genomes.begin(), genomes.begin() + (genomes.size() * p));
-	if (bestP.empty())
-		return genomes[0];
-	else
-		return bestP[rng.randInt(0, bestP.size()-1)];
+template<typename T>
+T* getPBest(std::vector<T*>const& genomes){
+	int const count = pBestCount(genomes.size());
+	std::vector<T*> top = genomes;
+	std::nth_element(top.begin(), top.begin() + (count-1), top.end(), comparePtrs); // Only the top count is needed, unordered
+	return top[rng.randInt(0, count-1)];
 }
 
 template<typename T>
@@ -0,0 +1,120 @@
+#include <IOHprofiler_experimenter.h>
+#include "batchproblem.h"
+#include "solution.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+
+BatchProblem::BatchProblem()
+	: handedX(NULL), handedY(0.){
+}
+
+BatchProblem::~BatchProblem(){}
+
+double BatchProblem::internal_evaluate(std::vector<double> const& x){
+	if (handedX == NULL)
+		return objective(ConstSpan(x.data(), x.size()));
+
+	double const* const expected = handedX;
+	handedX = NULL;
+	if (!std::equal(x.begin(), x.end(), expected))
+		throw std::logic_error("BatchProblem evaluated another position than the one whose value was handed over");
+	return handedY;
+}
+
+std::vector<double> BatchProblem::objectives(std::vector<Solution*> const& solutions, ThreadPool& pool) const {
+	std::vector<double> values(solutions.size());
+	pool.parallelFor(solutions.size(), [&](int const i){
+		values[i] = objective(solutions[i]->getXView());
+	});
+	return values;
+}
+
+void BatchProblem::handOver(ConstSpan const x, double const y){
+	handedX = x.data();
+	handedY = y;
+}
+
+SuiteBatchProblem::SuiteBatchProblem(std::string const suiteName, int const problemId, int const instance,
+		int const dimension, int const threads){
+	for (int i = 0; i < threads; i++){
+		copies.push_back(loadSuiteProblem(suiteName, problemId, instance, dimension));
+		idle.push_back(copies.back().get());
+	}
+
+	IOHprofiler_problem<double> const& problem = *copies.front();
+	IOHprofiler_set_problem_id(problem.IOHprofiler_get_problem_id());
+	IOHprofiler_set_instance_id(problem.IOHprofiler_get_instance_id());
+	IOHprofiler_set_problem_name(problem.IOHprofiler_get_problem_name());
+	IOHprofiler_set_number_of_objectives(1);
+	IOHprofiler_set_lowerbound(problem.IOHprofiler_get_lowerbound());
+	IOHprofiler_set_upperbound(problem.IOHprofiler_get_upperbound());
+	IOHprofiler_set_number_of_variables(dimension);
+	IOHprofiler_set_as_minimization();
+	IOHprofiler_set_optimal(problem.IOHprofiler_get_optimal()[0]);
+}
+
+double SuiteBatchProblem::objective(ConstSpan const x) const {
+	IOHprofiler_problem<double>* copy;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		released.wait(lock, [&]{return !idle.empty();}); // Only waits if there are more threads than copies
+		copy = idle.back();
+		idle.pop_back();
+	}
+	double const y = copy->evaluate(std::vector<double>(x.begin(), x.end()));
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		idle.push_back(copy);
+	}
+	released.notify_one();
+	return y;
+}
+
+std::shared_ptr<IOHprofiler_problem<double>> loadSuiteProblem(std::string const suiteName, int const problemId,
+		int const instance, int const dimension, int const evaluationThreads){
+	if (evaluationThreads > 1)
+		return std::make_shared<SuiteBatchProblem>(suiteName, problemId, instance, dimension, evaluationThreads);
+
+	std::shared_ptr<IOHprofiler_suite<double>> const suite =
+		genericGenerator<IOHprofiler_suite<double>>::instance().create(suiteName);
+	suite->IOHprofiler_set_suite_problem_id({problemId});
+	suite->IOHprofiler_set_suite_instance_id({instance});
+	suite->IOHprofiler_set_suite_dimension({dimension});
+	suite->loadProblem();
+	return suite->get_next_problem();
+}
+
+bool isBatchProblem(std::shared_ptr<IOHprofiler_problem<double> > const problem){
+	if (std::dynamic_pointer_cast<BatchProblem>(problem))
+		return true;
+
+	static std::atomic<bool> warned(false);
+	if (!warned.exchange(true))
+		std::cerr << "Warning: " << problem->IOHprofiler_get_problem_name() << " is not a BatchProblem, "
+			<< "so its objective values are computed serially" << std::endl;
+	return false;
+}
+
+void evaluateBatch(std::vector<Solution*> const& solutions, std::shared_ptr<IOHprofiler_problem<double> > const problem,
+		std::shared_ptr<IOHprofiler_csv_logger> const logger, ThreadPool& pool){
+	if (!isBatchProblem(problem)){
+		for (Solution* const s : solutions)
+			s->evaluate(problem, logger);
+		return;
+	}
+
+	BatchProblem* const batchProblem = static_cast<BatchProblem*>(problem.get());
+	std::vector<Solution*> pending; // Solution::evaluate skips evaluated solutions
+	for (Solution* const s : solutions)
+		if (!s->isEvaluated())
+			pending.push_back(s);
+
+	std::vector<double> const values = batchProblem->objectives(pending, pool);
+	for (unsigned int i = 0; i < pending.size(); i++){
+		batchProblem->handOver(pending[i]->getXView(), values[i]);
+		pending[i]->evaluate(problem, logger);
+	}
+}
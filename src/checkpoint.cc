@@ -0,0 +1,135 @@
+#include <IOHprofiler_problem.h>
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include "checkpoint.h"
+#include "rng.h"
+
+namespace {
+	char const magic[8] = {'P', 'S', 'O', 'D', 'E', 'C', 'K', 'P'};
+	uint32_t const version = 2;
+}
+
+CheckpointWriter::CheckpointWriter(std::string const path, std::string const kind)
+	: path(path), out(path + ".tmp", std::ios::binary | std::ios::trunc){
+	out.write(magic, sizeof(magic));
+	write(version);
+	write(kind);
+}
+
+void CheckpointWriter::write(std::string const& s){
+	write<uint64_t>(s.size());
+	out.write(s.data(), s.size());
+}
+
+void CheckpointWriter::commit(){
+	out.close();
+	if (out.fail() || std::rename((path + ".tmp").c_str(), path.c_str()) != 0)
+		throw std::runtime_error("Could not write checkpoint " + path);
+}
+
+CheckpointReader::CheckpointReader(std::string const path, std::string const kind)
+	: path(path), in(path, std::ios::binary){
+	char header[sizeof(magic)];
+	in.read(header, sizeof(header));
+	check();
+	if (!std::equal(header, header + sizeof(header), magic))
+		throw std::runtime_error(path + " is not a checkpoint");
+
+	uint32_t fileVersion;
+	read(fileVersion);
+	if (fileVersion != version)
+		throw std::runtime_error(path + " has checkpoint version " + std::to_string(fileVersion) +
+				", expected " + std::to_string(version));
+
+	std::string fileKind;
+	read(fileKind);
+	if (fileKind != kind)
+		throw std::runtime_error(path + " is a checkpoint of " + fileKind + ", not of " + kind);
+}
+
+void CheckpointReader::check(){
+	if (!in)
+		throw std::runtime_error("Checkpoint " + path + " is truncated");
+}
+
+void CheckpointReader::read(std::string& s){
+	uint64_t size;
+	read(size);
+	s.resize(size);
+	in.read(&s[0], size);
+	check();
+}
+
+void CheckpointReader::expect(int64_t const value, std::string const what){
+	int64_t stored;
+	read(stored);
+	if (stored != value)
+		throw std::runtime_error("Checkpoint " + path + " has " + what + " " + std::to_string(stored) +
+				", expected " + std::to_string(value));
+}
+
+RunCheckpoint::RunCheckpoint(CheckpointSettings const settings, std::string const kind,
+		std::shared_ptr<IOHprofiler_problem<double>> const problem, int const popSize, int const evalBudget)
+	: settings(settings), kind(kind), problem(problem), popSize(popSize), evalBudget(evalBudget),
+		evaluationOffset(0), resumedIteration(-1){
+}
+
+bool RunCheckpoint::exists() const {
+	return settings.interval > 0 && std::ifstream(settings.path).good();
+}
+
+int RunCheckpoint::evaluations() const {
+	return evaluationOffset + problem->IOHprofiler_get_evaluations();
+}
+
+bool RunCheckpoint::due(int const iteration) const {
+	return settings.interval > 0 && iteration > 0 && iteration % settings.interval == 0 && iteration != resumedIteration;
+}
+
+void RunCheckpoint::writeRun(CheckpointWriter& writer) const {
+	writer.write<int64_t>(rng.getSeed());
+	writer.write<int64_t>(problem->IOHprofiler_get_problem_id());
+	writer.write<int64_t>(problem->IOHprofiler_get_instance_id());
+	writer.write<int64_t>(problem->IOHprofiler_get_number_of_variables());
+	writer.write<int64_t>(popSize);
+	writer.write<int64_t>(evalBudget);
+}
+
+void RunCheckpoint::expectRun(CheckpointReader& reader) const {
+	reader.expect(int64_t(rng.getSeed()), "seed");
+	reader.expect(problem->IOHprofiler_get_problem_id(), "problem");
+	reader.expect(problem->IOHprofiler_get_instance_id(), "instance");
+	reader.expect(problem->IOHprofiler_get_number_of_variables(), "dimension");
+	reader.expect(popSize, "population size");
+	reader.expect(evalBudget, "budget");
+}
+
+void RunCheckpoint::save(int const iteration, std::function<void(CheckpointWriter&)> const state) const {
+	CheckpointWriter writer(settings.path, kind);
+	writeRun(writer);
+	writer.write<int64_t>(evaluations());
+	writer.write<int64_t>(iteration);
+	state(writer);
+	rng.save(writer);
+	writer.commit();
+}
+
+int RunCheckpoint::load(std::function<void(CheckpointReader&)> const state){
+	CheckpointReader reader(settings.path, kind);
+	expectRun(reader);
+	int64_t evaluations, iteration;
+	reader.read(evaluations);
+	reader.read(iteration);
+	state(reader);
+	rng.load(reader);
+
+	evaluationOffset = evaluations - problem->IOHprofiler_get_evaluations();
+	resumedIteration = iteration;
+	return iteration;
+}
+
+void RunCheckpoint::finish() const {
+	if (settings.interval > 0)
+		std::remove(settings.path.c_str());
+}
@@ -0,0 +1,124 @@
+#include "configurationspace.h"
+#include "rng.h"
+#include <limits>
+#include <stdexcept>
+
+Configuration::Configuration(std::vector<std::vector<std::string>> const& components)
+	: components(&components), ids(components.size(), 0){
+}
+
+int Configuration::size() const {
+	return ids.size();
+}
+
+int Configuration::id(int const component) const {
+	return ids[component];
+}
+
+std::string const& Configuration::operator[](int const component) const {
+	return (*components)[component][ids[component]];
+}
+
+std::vector<std::string> Configuration::names() const {
+	std::vector<std::string> names(ids.size());
+	for (int c = 0; c < int(ids.size()); c++)
+		names[c] = (*this)[c];
+	return names;
+}
+
+ConfigurationSpace::ConfigurationSpace(int const components)
+	: components(components), listed(false){
+}
+
+void ConfigurationSpace::setComponent(int const component, std::vector<std::string> const values){
+	components[component] = values;
+	listed = false;
+}
+
+void ConfigurationSpace::addFilter(Filter const filter){
+	filters.push_back(filter);
+	listed = false;
+}
+
+int64_t ConfigurationSpace::fullSize() const {
+	int64_t size = 1;
+	for (std::vector<std::string> const& values : components){
+		int64_t const radix = values.size();
+		if (radix != 0 && size > std::numeric_limits<int64_t>::max() / radix)
+			throw std::overflow_error("The configuration space has more than 2^63 configurations");
+		size *= radix;
+	}
+	return size;
+}
+
+void ConfigurationSpace::decode(int64_t index, Configuration& configuration) const {
+	for (int c = components.size() - 1; c >= 0; c--){
+		int64_t const radix = components[c].size();
+		configuration.ids[c] = index % radix;
+		index /= radix;
+	}
+}
+
+bool ConfigurationSpace::accepts(Configuration const& configuration) const {
+	for (Filter const& filter : filters)
+		if (!filter(configuration))
+			return false;
+	return true;
+}
+
+void ConfigurationSpace::list() const {
+	int64_t const n = fullSize();
+	if (n > std::numeric_limits<int>::max())
+		throw std::overflow_error(std::to_string(n) + " configurations are too many to filter, sample() them instead");
+
+	accepted.clear();
+	Configuration configuration(components);
+	for (int64_t i = 0; i < n; i++){
+		decode(i, configuration);
+		if (accepts(configuration))
+			accepted.push_back(i);
+	}
+	listed = true;
+}
+
+int ConfigurationSpace::size() const {
+	int64_t n;
+	if (filters.empty())
+		n = fullSize();
+	else {
+		if (!listed)
+			list();
+		n = accepted.size();
+	}
+
+	if (n > std::numeric_limits<int>::max())
+		throw std::overflow_error(std::to_string(n) + " configurations cannot be indexed, sample() them instead");
+	return n;
+}
+
+std::vector<std::string> ConfigurationSpace::get(int const i) const {
+	if (i < 0 || i >= size())
+		throw std::out_of_range("Configuration " + std::to_string(i) + " does not exist");
+
+	Configuration configuration(components);
+	decode(filters.empty() ? i : accepted[i], configuration);
+	return configuration.names();
+}
+
+std::vector<std::string> ConfigurationSpace::sample() const {
+	for (std::vector<std::string> const& values : components)
+		if (values.empty())
+			throw std::out_of_range("The configuration space is empty");
+
+	// Rejection only gives up if hardly any configuration passes the filters
+	Configuration configuration(components);
+	for (int attempt = 0; attempt < 1000; attempt++){
+		for (int c = 0; c < int(components.size()); c++)
+			configuration.ids[c] = rng.randInt(0, components[c].size() - 1);
+		if (accepts(configuration))
+			return configuration.names();
+	}
+	if (size() == 0)
+		throw std::out_of_range("No configuration passes the filters");
+	return get(rng.randInt(0, size() - 1));
+}
@@ -1,17 +1,23 @@
 #include "constrainthandler.h"
 #include "particle.h"
 #include "repairhandler.h"
+#include "checkpoint.h"
 #define LC(X) [](std::vector<double>lb, std::vector<double>ub){return new X(lb,ub);}
 
 bool ConstraintHandler::isFeasible(Solution const * const p) const{
-	for (int i = 0; i < D; i++){
-		if (p->getX(i) < lb[i] || p->getX(i) > ub[i]){
+	for (int start = 0; start < D; start += 64){
+		int const n = std::min(64, D - start);
+		if (kernels->boundViolations(p->getXView().data() + start, &lb[start], &ub[start], n) != 0)
 			return false;
-		}
 	}
 	return true;
 }
 
+void DEConstraintHandler::repairBatch(std::vector<Solution*> const& solutions){
+	for (Solution* const s : solutions)
+		repair(s);
+}
+
 bool ConstraintHandler::resample(Solution * const p, int const resamples){
 	return false;
 }
@@ -20,31 +26,28 @@ int ConstraintHandler::getCorrections() const {
 	return nCorrected;
 }
 
-std::map<std::string, std::function<DEConstraintHandler*(std::vector<double>, std::vector<double>)>> const deCHs ({
-	// Generic
-	{"DP", LC(DeathPenalty)},
-	{"RS", LC(ResamplingRepair)},
+void ConstraintHandler::save(CheckpointWriter& writer) const {
+	writer.write<int32_t>(nCorrected);
+}
 
-	// Almost generic
-	{"RI", LC(ReinitializationRepair)},
-	{"PR", LC(ProjectionRepair)},
-	{"RF", LC(ReflectionRepair)},
-	{"WR", LC(WrappingRepair)},
-	{"TR", LC(TransformationRepair)},
+void ConstraintHandler::load(CheckpointReader& reader){
+	int32_t corrections;
+	reader.read(corrections);
+	nCorrected = corrections;
+}
 
-	//// DE
-	{"RB", LC(RandBaseRepair)},
-	{"MB", LC(MidpointBaseRepair)},
-	{"MT", LC(MidpointTargetRepair)},
-	{"PM", LC(ProjectionMidpointRepair)},
-	{"PB", LC(ProjectionBaseRepair)},
-	{"CO", LC(ConservatismRepair)}
+std::set<std::string> const optInCHs {"RC"};
+
+#define ENTRY(KEY, X, HOOKS) {#KEY, LC(X)},
+std::map<std::string, std::function<DEConstraintHandler*(std::vector<double>, std::vector<double>)>> const deCHs ({
+	DE_REPAIRS(ENTRY)
 });
 
 std::map<std::string, std::function<PSOConstraintHandler*(std::vector<double>, std::vector<double>)>> const psoCHs {
 	// Generic
 	{"DP", LC(DeathPenalty)},
 	{"RS", LC(ResamplingRepair)},
+	{"RC", LC(DimensionResamplingRepair)},
 
 	// Almost generic
 	{"RI", LC(ReinitializationRepair)},
@@ -1,72 +1,89 @@
 #include "util.h"
 #include "crossovermanager.h"
-#include<unordered_set>
+#include "simd.h"
+#include <algorithm>
 
-CrossoverManager::CrossoverManager(int const D): D(D){}
+CrossoverManager::CrossoverManager(int const D): D(D), kernels(getVectorKernels(D)), x(D){}
 CrossoverManager::~CrossoverManager(){}
 
 std::vector<Solution*> CrossoverManager::crossover(std::vector<Solution*>const& genomes, std::vector<Solution*>const& mutants, std::vector<double>const& Crs) const{
-	std::vector<Solution*> trials;
-	trials.reserve(genomes.size());
-	std::vector<double> x(D);
+	std::vector<Solution*> trials(genomes.size());
+	for (unsigned int i = 0; i < genomes.size(); i++)
+		trials[i] = new Solution(D);
 
+	crossover(genomes, mutants, Crs, trials);
+	return trials;
+}
+
+void CrossoverManager::crossover(std::vector<Solution*>const& genomes, std::vector<Solution*>const& mutants, std::vector<double>const& Crs, std::vector<Solution*>const& trials) const{
 	for (unsigned int i = 0; i < genomes.size(); i++){
-		trials.push_back(new Solution(singleCrossover(genomes[i]->getX(), mutants[i]->getX(), Crs[i])));
+		singleCrossover(genomes[i]->getXView(), mutants[i]->getXView(), Crs[i], x);
+		std::copy(x.begin(), x.end(), trials[i]->modifyX());
 	}
-	return trials;
 }
 
 #define LC(X) [](int const D){return new X(D);}
+#define ENTRY(KEY, X) {#KEY, LC(X)},
 std::map<std::string, std::function<CrossoverManager* (int const)>> const crossovers({
-		{"B", LC(BinomialCrossoverManager)},
-		{"E", LC(ExponentialCrossoverManager)},
-		{"A", LC(ArithmeticCrossoverManager)},
+		DE_CROSSOVERS(ENTRY)
 });
 
-std::vector<double> BinomialCrossoverManager::singleCrossover(std::vector<double>const& target, 
-		std::vector<double>const& donor, double const Cr) const{
-	std::vector<double> x(D);
+/*		Mask based		*/
+void MaskCrossoverManager::crossover(std::vector<Solution*>const& genomes, std::vector<Solution*>const& mutants, std::vector<double>const& Crs, std::vector<Solution*>const& trials) const{
+	int const popSize = genomes.size();
+	masks.resize(popSize * words);
+	for (int i = 0; i < popSize; i++)
+		createMask(Crs[i], &masks[i * words]);
 
-	int const jrand = rng.randInt(0,D-1);
-	for (int j = 0; j < D; j++){
-		if (j == jrand || rng.randDouble(0,1) < Cr){
-			x[j] = donor[j];
-		} else {
-			x[j] = target[j]; 
-		}
-	}
-	return x;
+	for (int i = 0; i < popSize; i++)
+		kernels->select(genomes[i]->getXView().data(), mutants[i]->getXView().data(), &masks[i * words], trials[i]->modifyX(), D);
 }
 
-std::vector<double> ExponentialCrossoverManager::singleCrossover(std::vector<double>const& target, 
-		std::vector<double>const& donor, double const Cr) const{
-	std::vector<double> x = target;
-	int const start = rng.randInt(0,D-1);
+void MaskCrossoverManager::singleCrossover(ConstSpan const target, 
+		ConstSpan const donor, double const Cr, std::vector<double>& x) const{
+	createMask(Cr, masks.data());
+	kernels->select(target.data(), donor.data(), masks.data(), x.data(), D);
+}
 
-	int L = 1;
-	while (L < D && rng.randDouble(0,1) <= Cr)
-		L++;
+void BinomialCrossoverManager::createMask(double const Cr, uint64_t* const mask) const{
+	rng.fillBernoulli(mask, D, Cr);
+	int const jrand = rng.randInt(0,D-1); // At least one coordinate from the donor
+	mask[jrand / 64] |= uint64_t(1) << (jrand % 64);
+}
 
-	int const end = (start+L-1) % D;
+namespace {
+	void setBits(uint64_t* const mask, int const from, int const to){ // Bits from..to-1
+		for (int j = from; j < to; j = (j / 64 + 1) * 64){
+			int const last = std::min(to, (j / 64 + 1) * 64);
+			uint64_t const ones = last - j == 64 ? ~uint64_t(0) : ((uint64_t(1) << (last - j)) - 1);
+			mask[j / 64] |= ones << (j % 64);
+		}
+	}
+}
 
-	auto const condition = end >= start ? \
-		[](int const i, int const start, int const end) {return i >= start && i <= end;}: 
-		[](int const i, int const start, int const end) {return i <= end || i >= start;};
+void ExponentialCrossoverManager::createMask(double const Cr, uint64_t* const mask) const{
+	std::fill(mask, mask + words, 0);
+	int const start = rng.randInt(0,D-1);
+	int const L = 1 + rng.geometric(Cr, D - 1); // Length of the segment taken from the donor
 
-	for (int i = 0; i < D; i++)
-		if (condition(i, start, end))
-			x[i] = donor[i];
+	if (start + L <= D)
+		setBits(mask, start, start + L);
+	else { // The segment wraps around
+		setBits(mask, start, D);
+		setBits(mask, 0, start + L - D);
+	}
+}
 
-	return x; 
+/*		Arithmetic		*/
+void ArithmeticCrossoverManager::crossover(std::vector<Solution*>const& genomes, std::vector<Solution*>const& mutants, std::vector<double>const& Crs, std::vector<Solution*>const& trials) const{
+	for (unsigned int i = 0; i < genomes.size(); i++){
+		double const* const target = genomes[i]->getXView().data();
+		kernels->addScaledDifference(target, mutants[i]->getXView().data(), target, rng.randDouble(0,1), trials[i]->modifyX(), D);
+	}
 }
 
-std::vector<double> ArithmeticCrossoverManager::singleCrossover(std::vector<double>const& target, 
-		std::vector<double>const& donor, double const Cr) const{
-	std::vector<double> x = target;
+void ArithmeticCrossoverManager::singleCrossover(ConstSpan const target, 
+		ConstSpan const donor, double const Cr, std::vector<double>& x) const{
 	double const k = rng.randDouble(0,1);
-	std::vector<double> subtraction(D);
-	subtract(donor, target, subtraction);
-	scale(subtraction, k);
-	add(x, subtraction, x);
-	return x;
+	kernels->addScaledDifference(target.data(), donor.data(), target.data(), k, x.data(), D);
 }
@@ -4,6 +4,7 @@
 #include <iostream>
 #include "rng.h"
 #include "util.h"
+#include "checkpoint.h"
 
 #define LC(X) [](int const popSize){return new X(popSize);}
 std::map<std::string, std::function<DEAdaptationManager*(int const)>> const deAdaptations({
@@ -12,62 +13,68 @@ std::map<std::string, std::function<DEAdaptationManager*(int const)>> const deAd
 		{"N", LC(NoAdaptationManager)},
 });
 
-DEAdaptationManager::DEAdaptationManager(int const popSize): popSize(popSize){}
+DEAdaptationManager::DEAdaptationManager(int const popSize): popSize(popSize), improvement(popSize, 0.){}
+
+void DEAdaptationManager::save(CheckpointWriter& writer) const {}
+
+void DEAdaptationManager::load(CheckpointReader& reader){}
 
 //JADE
 JADEManager::JADEManager(int const popSize)
-	: DEAdaptationManager(popSize), MuCr(0.5), MuF(0.6), c(0.1){}
+	: DEAdaptationManager(popSize), MuCr(0.5), MuF(0.6), c(0.1), order(popSize){
+	std::iota(order.begin(), order.end(), 0);
+}
 
-void JADEManager::update(std::vector<double>const& orig, std::vector<double>const& trials){
-	std::vector<double> SF, SCr;
+void JADEManager::update(std::vector<double>const& Fs, std::vector<double>const& Crs){
+	int successes = 0;
+	double sumCr = 0., sumF = 0., sumFSq = 0.;
 	for (int i = 0; i < popSize; i++){
-		if (trials[i] < orig[i]){
-			SF.push_back(previousFs[i]); 
-			SCr.push_back(previousCrs[i]);
+		if (succeeded(i)){
+			successes++;
+			sumCr += Crs[i];
+			sumF += Fs[i];
+			sumFSq += Fs[i] * Fs[i];
 		}
 	}
 
-	if (!SCr.empty()){
-		MuCr = (1.0-c) * MuCr + c * (std::accumulate(SCr.begin(), SCr.end(), 0.0)/SCr.size());
+	if (successes > 0){
+		MuCr = (1.0-c) * MuCr + c * (sumCr / successes);
 		MuCr = std::min(std::max(MuCr, 0.01), 1.0);
-	}
 
-	if (!SF.empty()){
-		MuF = (1.0-c) * MuF + c * lehmerMean(SF);
+		MuF = (1.0-c) * MuF + c * (sumFSq / sumF); // Lehmer mean
 		MuF = std::min(std::max(MuF, 0.01), 1.2);
 	}
 }
 
 void JADEManager::nextF(std::vector<double>& Fs){
-	int third = popSize/3;
-	std::vector<double> indices(popSize);
-	std::iota(indices.begin(), indices.end(), 0);
-	rng.shuffle(indices.begin(), indices.end());
-
-	for (int i = 0; i < third; i++)
-		Fs[indices[i]] = rng.randDouble(0.0,1.2);
-
-	for (int i = third; i < popSize; i++){
-		do {
-			Fs[indices[i]] = std::min(rng.normalDistribution(MuF, 0.1),1.2);	
-		} while ( Fs[indices[i]] <= 0. );
+	int const third = popSize/3;
+	rng.fillTruncatedNormal(Fs.data(), popSize, MuF, 0.1, 0.);
+	for (int i = 0; i < popSize; i++)
+		Fs[i] = std::min(Fs[i], 1.2);
+
+	// A third of the population, picked by a partial Fisher-Yates shuffle, gets a uniform F
+	for (int i = 0; i < third; i++){
+		std::swap(order[i], order[rng.randInt(i, popSize - 1)]);
+		Fs[order[i]] = rng.randDouble(0.0, 1.2);
 	}
-
-	previousFs = Fs;
 }
 
 void JADEManager::nextCr(std::vector<double>& Crs){
-	for (int i = 0; i < popSize; i++){
-		Crs[i] = std::min(std::max(rng.normalDistribution(MuCr, 0.1),0.0),1.0);
-	}
+	rng.fillNormal(Crs.data(), popSize, MuCr, 0.1);
+	for (int i = 0; i < popSize; i++)
+		Crs[i] = std::min(std::max(Crs[i],0.0),1.0);
+}
 
-	previousCrs = Crs;
+void JADEManager::save(CheckpointWriter& writer) const {
+	writer.write(MuCr);
+	writer.write(MuF);
+	writer.write(order);
 }
 
-double JADEManager::lehmerMean(std::vector<double>const& SF) const {
-	double sumOfSquares = std::inner_product(SF.begin(), SF.end(), SF.begin(), 0.0);
-	double sum = std::accumulate(SF.begin(), SF.end(), 0.0);
-	return sumOfSquares/sum;
+void JADEManager::load(CheckpointReader& reader){
+	reader.read(MuCr);
+	reader.read(MuF);
+	reader.readInPlace(order);
 }
 
 // SHADE
@@ -79,47 +86,22 @@ SHADEManager::SHADEManager(int const popSize) : DEAdaptationManager(popSize), H(
 	std::fill(MF.begin(), MF.end(), 0.5);
 }
 
-double SHADEManager::weightedMean(std::vector<double>const& x, std::vector<double>const& w)const{
-	double sum = 0;
-	for (unsigned int i = 0; i < x.size(); i++)
-		sum += w[i] * x[i];
-	return sum;
-}
-
-double SHADEManager::weightedLehmerMean(std::vector<double>const& x, std::vector<double>const& w)const{
-	double wSqSum=0;
-	double wSum=0;
-
-	for (unsigned int i = 0; i < x.size(); i++){
-		wSqSum += w[i]*(x[i]*x[i]);
-		wSum += w[i]*x[i];
-	}
-
-	return wSqSum / wSum;
-}
-
-std::vector<double> SHADEManager::w(std::vector<double>const& delta) const {
-	std::vector<double> w(delta.size());
-	double sum = std::accumulate(delta.begin(), delta.end(), 0.);
-	for (unsigned int i = 0; i < delta.size(); i++)
-		w[i] = delta[i]/sum;
-	return w;
-}
-
-void SHADEManager::update(std::vector<double>const& targets, std::vector<double>const& trials){
-	std::vector<double> SF, SCr, delta;
+void SHADEManager::update(std::vector<double>const& Fs, std::vector<double>const& Crs){
+	// The weights are the improvements normalized by their sum, which cancels in the Lehmer mean
+	double sumDelta = 0., sumDeltaF = 0., sumDeltaFSq = 0., sumDeltaCr = 0.;
 	for (int i = 0; i < popSize; i++){
-		if (trials[i] < targets[i]){
-			SF.push_back(previousFs[i]); 
-			SCr.push_back(previousCrs[i]);
-			delta.push_back(std::abs(trials[i] - targets[i]));
+		double const delta = improvement[i];
+		if (delta > 0.){
+			sumDelta += delta;
+			sumDeltaF += delta * Fs[i];
+			sumDeltaFSq += delta * Fs[i] * Fs[i];
+			sumDeltaCr += delta * Crs[i];
 		}
 	}
 
-	if (!SF.empty()){
-		std::vector<double> const _w = w(delta);
-		MF[k] = weightedLehmerMean(SF, _w);
-		MCr[k] = weightedMean(SCr, _w);
+	if (sumDelta > 0.){
+		MF[k] = sumDeltaFSq / sumDeltaF;
+		MCr[k] = sumDeltaCr / sumDelta;
 		k = (k+1)%H;
 	}
 
@@ -128,28 +110,40 @@ void SHADEManager::update(std::vector<double>const& targets, std::vector<double>
 }
 
 void SHADEManager::nextF(std::vector<double>& Fs){
-	for (int i = 0; i < popSize; i++){
-		double const MFr = MF[r[i]];
-		do{
-			Fs[i] = std::min(rng.cauchyDistribution(MFr, 0.1), 1.);
-		} while (Fs[i] <= 0.);
-	}
-	previousFs = Fs;
+	for (int i = 0; i < popSize; i++)
+		Fs[i] = MF[r[i]];
+	rng.fillTruncatedCauchy(Fs.data(), popSize, Fs.data(), 0.1, 0.);
+	for (int i = 0; i < popSize; i++)
+		Fs[i] = std::min(Fs[i], 1.);
 }
 
 void SHADEManager::nextCr(std::vector<double>& Crs){
-	for (int i = 0; i < popSize; i++){
-		double const MCrr = MCr[r[i]];
-		Crs[i] = std::min(std::max(rng.normalDistribution(MCrr, 0.1),0.),1.);
-	}
-	previousCrs = Crs;
+	rng.fillNormal(Crs.data(), popSize, 0., 0.1);
+	for (int i = 0; i < popSize; i++)
+		Crs[i] = std::min(std::max(Crs[i] + MCr[r[i]],0.),1.);
+}
+
+void SHADEManager::save(CheckpointWriter& writer) const {
+	writer.write(MCr);
+	writer.write(MF);
+	writer.write(r);
+	writer.write<int32_t>(k);
+}
+
+void SHADEManager::load(CheckpointReader& reader){
+	reader.readInPlace(MCr);
+	reader.readInPlace(MF);
+	reader.readInPlace(r);
+	int32_t position;
+	reader.read(position);
+	k = position;
 }
 
 //NO ADAPTATION
 NoAdaptationManager::NoAdaptationManager(int const popSize)
 	: DEAdaptationManager(popSize), F(0.5), Cr(.9){}
 
-void NoAdaptationManager::update(std::vector<double>const& orig, std::vector<double>const& trials){
+void NoAdaptationManager::update(std::vector<double>const& Fs, std::vector<double>const& Crs){
 	//ignore
 }
 
@@ -0,0 +1,266 @@
+#include <IOHprofiler_problem.h>
+#include <IOHprofiler_csv_logger.h>
+#include <string>
+#include "deengine.h"
+#include "rng.h"
+#include "util.h"
+#include "repairhandler.h"
+#include "logger.h"
+#include "population.h"
+#include "generationarena.h"
+#include "batchproblem.h"
+#include "threadpool.h"
+#include "checkpoint.h"
+#include <type_traits>
+
+// State of a run that its generations work on
+struct DEGeneration {
+	std::shared_ptr<IOHprofiler_problem<double> > const problem;
+	std::shared_ptr<IOHprofiler_csv_logger> const iohLogger;
+	std::vector<Solution*> const& genomes;
+	std::vector<Solution*> const& donors;
+	std::vector<Solution*> const& trials;
+	std::vector<double> const& Fs;
+	std::vector<double> const& Crs;
+	MutationManager& mutation;
+	CrossoverManager const& crossover;
+	DEConstraintHandler& deCH;
+	DEAdaptationManager& adaptation;
+	ThreadPool* const pool;
+	RunCheckpoint const& checkpoint;
+	ResampleLogger& loggerResamples;
+	std::vector<double>& percCorrected;
+	int* const lanes; // Infeasible coordinates when resampling per coordinate, NULL otherwise
+};
+
+// Calls the per-mutant hooks of the constraint handler through Repair, so that they are not dispatched
+template <typename Repair>
+struct DirectRepair {
+	Repair& repair;
+	void repairDE(Solution* const p, Solution const* const base, Solution const* const target){
+		repair.Repair::repairDE(p, base, target);
+	}
+	bool resample(Solution* const p, int const resamples){
+		return repair.Repair::resample(p, resamples);
+	}
+	int coordinatesToRedraw(double* const x, int const resamples, int const redrawn, int* const lanes){
+		return repair.Repair::coordinatesToRedraw(x, resamples, redrawn, lanes);
+	}
+};
+
+template <typename Mutation, typename Crossover, typename Repair>
+class DEEngine : public DERunner {
+	protected:
+		MutationManager* createMutation(int const D, DEConstraintHandler* const deCH) const {
+			return new Mutation(D, deCH);
+		}
+		CrossoverManager* createCrossover(int const D) const {
+			return new Crossover(D);
+		}
+		void generation(DEGeneration& state) const;
+	public:
+		DEEngine(DEConfig const config, std::string const idString, bool const useArena, int const evaluationThreads,
+				CheckpointSettings const checkpointSettings)
+			: DERunner(config, idString, useArena, evaluationThreads, checkpointSettings){};
+};
+
+template <typename Mutation, typename Crossover, typename Repair>
+void DEEngine<Mutation, Crossover, Repair>::generation(DEGeneration& state) const {
+	// The managers were created with these types, so the qualified calls below are not dispatched
+	Mutation& mutationManager = static_cast<Mutation&>(state.mutation);
+	Crossover const& crossoverManager = static_cast<Crossover const&>(state.crossover);
+	Repair& deCH = static_cast<Repair&>(state.deCH);
+
+	std::vector<Solution*> const& genomes = state.genomes;
+	std::vector<Solution*> const& donors = state.donors;
+	std::vector<Solution*> const& trials = state.trials;
+	int const popSize = genomes.size();
+
+	mutationManager.prepare(genomes, state.Fs);
+	DirectRepair<Repair> repair = {deCH};
+	for (int i = 0; i < popSize; i++)
+		mutateFeasible([&mutationManager, i](Solution* const m, Lanes const lanes){return mutationManager.Mutation::mutate(i, m, lanes);},
+			repair, donors[i], genomes[i], state.lanes);
+	deCH.repairBatch(donors); // Generic repair of the whole generation at once
+	state.loggerResamples.log(deCH.takeResampleHistogram());
+
+	crossoverManager.Crossover::crossover(genomes, donors, state.Crs, trials);
+
+	int const firstEval = state.checkpoint.evaluations();
+	if (state.pool)
+		evaluateBatch(trials, state.problem, state.iohLogger, *state.pool);
+
+	for (int i = 0; i < popSize; i++){
+		double const parentF = genomes[i]->getFitness();
+
+		trials[i]->evaluate(state.problem, state.iohLogger); // No-op if evaluated in a batch
+
+		deCH.Repair::penalize(trials[i]); // This is done after and not before the evaluation, because otherwise it could loop endlessly
+
+		double const trialF = trials[i]->getFitness();
+		state.adaptation.recordTrial(i, parentF, trialF);
+
+		int const numEval = firstEval + i + 1; // Evaluations up to and including this trial
+		if (numEval != 0 && numEval % 100000 == 0)
+			state.percCorrected.push_back(double(deCH.getCorrections()) / numEval);
+
+		if (state.adaptation.succeeded(i))
+			genomes[i]->setX(trials[i]->getXView(), trialF);
+	}
+}
+
+DERunner::DERunner(DEConfig const config, std::string const idString, bool const useArena, int const evaluationThreads,
+		CheckpointSettings const checkpointSettings)
+	: config(config), idString(idString), useArena(useArena), evaluationThreads(evaluationThreads),
+	checkpointSettings(checkpointSettings){
+}
+
+void DERunner::run(std::shared_ptr<IOHprofiler_problem<double> > const problem, 
+			std::shared_ptr<IOHprofiler_csv_logger> const iohLogger, 
+			int const evalBudget, int const popSize) const {
+
+	int const D = problem->IOHprofiler_get_number_of_variables();
+	std::vector<double> const lowerBound = problem->IOHprofiler_get_lowerbound();
+	std::vector<double> const upperBound = problem->IOHprofiler_get_upperbound();
+
+	Population population(popSize, D);
+	std::vector<Solution*> const& genomes = population.getSolutions();
+
+	// Only the objective values of a BatchProblem can be computed in parallel
+	ThreadPool* const pool = evaluationThreads > 1 && isBatchProblem(problem) ? new ThreadPool(evaluationThreads) : NULL;
+
+	RunCheckpoint checkpoint(checkpointSettings, "DE_" + config.mutation + "_" + config.crossover + "_" +
+			config.adaptation + "_" + config.constraintHandler, problem, popSize, evalBudget);
+	bool const resume = checkpoint.exists();
+
+	if (!resume){ // Otherwise the population is loaded below
+		for (int i = 0; i < popSize; i++)
+			genomes[i]->randomize(lowerBound, upperBound);
+
+		if (pool)
+			evaluateBatch(genomes, problem, iohLogger, *pool);
+		else
+			for (int i = 0; i < popSize; i++)
+				genomes[i]->evaluate(problem, iohLogger);
+	}
+
+	DEConstraintHandler * const deCH = deCHs.at(config.constraintHandler)(lowerBound, upperBound);
+	CrossoverManager const* const crossoverManager = createCrossover(D);
+	MutationManager* const mutationManager = createMutation(D, deCH);
+	DEAdaptationManager* const adaptationManager = deAdaptations.at(config.adaptation)(popSize);
+
+	std::vector<double> Fs(popSize);
+	std::vector<double> Crs(popSize);
+	std::vector<double> percCorrected; 
+
+	GenerationArena* arena = useArena ? new GenerationArena(popSize, D) : NULL;
+
+	Logger logger("scratch/extra_data/" + idString + ".dat");
+	Logger loggerParams("scratch/extra_data/" + idString + ".par");
+
+	loggerParams.start(problem->IOHprofiler_get_problem_id(), D);
+	ResampleLogger loggerResamples("scratch/extra_data/" + idString + ".rsp", problem->IOHprofiler_get_problem_id(), D);
+
+	std::vector<int> lanes(D);
+
+	int iteration = 0;
+	if (resume)
+		iteration = checkpoint.load([&](CheckpointReader& reader){
+			population.load(reader);
+			adaptationManager->load(reader);
+			mutationManager->load(reader);
+			deCH->load(reader);
+			reader.read(percCorrected);
+		});
+
+	while (checkpoint.evaluations() < evalBudget && !problem->IOHprofiler_hit_optimal()){
+		if (checkpoint.due(iteration))
+			checkpoint.save(iteration, [&](CheckpointWriter& writer){
+				population.save(writer);
+				adaptationManager->save(writer);
+				mutationManager->save(writer);
+				deCH->save(writer);
+				writer.write(percCorrected);
+			});
+
+		adaptationManager->nextF(Fs);
+		adaptationManager->nextCr(Crs);
+
+		if (iteration % 10 == 0)
+			loggerParams.log(Fs, Crs);
+
+		if (!useArena) // Fresh donor and trial vectors every generation
+			arena = new GenerationArena(popSize, D);
+
+		DEGeneration state = {problem, iohLogger, genomes, arena->getDonors(), arena->getTrials(), Fs, Crs,
+			*mutationManager, *crossoverManager, *deCH, *adaptationManager, pool, checkpoint, loggerResamples,
+			percCorrected, deCH->resamplesDimensions() ? lanes.data() : NULL};
+		generation(state);
+
+		if (!useArena){
+			delete arena;
+			arena = NULL;
+		}
+
+		adaptationManager->update(Fs, Crs);
+		iteration++;
+	}
+
+	if (percCorrected.empty()){
+		double const perc = double(deCH->getCorrections()) / checkpoint.evaluations();
+		percCorrected.resize(3, perc);
+	} else if (percCorrected.size() < 3){
+		int const lastIndex = percCorrected.size() -1;
+		for (int i = lastIndex+1; i < 3; i++)
+			percCorrected.push_back(percCorrected[lastIndex]);
+	}
+
+	Solution const*const best = getBest(genomes);
+
+	logger.log(problem->IOHprofiler_get_problem_id(), D, percCorrected, best->getX(), best->getFitness(), checkpoint.evaluations());
+	loggerParams.newLine();
+	checkpoint.finish();
+
+	delete adaptationManager;
+	delete mutationManager;
+	delete crossoverManager;
+	delete deCH;
+	delete arena;
+	delete pool;
+}
+
+/*		Registry: an engine for every mutation, crossover and constraint handler		*/
+typedef std::map<std::string, std::function<DERunner* (DEConfig const, std::string const, bool const, int const, CheckpointSettings const)>> EngineRegistry;
+
+template <typename Mutation, typename Crossover, typename Repair>
+DERunner* createEngine(DEConfig const config, std::string const idString, bool const useArena, int const evaluationThreads,
+		CheckpointSettings const checkpointSettings){
+	return new DEEngine<Mutation, Crossover, Repair>(config, idString, useArena, evaluationThreads, checkpointSettings);
+}
+
+template <typename Mutation, typename Crossover>
+void addRepairEngines(EngineRegistry& registry, std::string const key){
+#define ADD_ENGINE(KEY, X, HOOKS) \
+	static_assert(std::is_base_of<HOOKS, X>::value, #X " does not derive from " #HOOKS); \
+	registry[key + "_" #KEY] = createEngine<Mutation, Crossover, HOOKS>;
+	DE_REPAIRS(ADD_ENGINE)
+#undef ADD_ENGINE
+}
+
+template <typename Mutation>
+void addCrossoverEngines(EngineRegistry& registry, std::string const key){
+#define ADD_ENGINES(KEY, X) addRepairEngines<Mutation, X>(registry, key + "_" #KEY);
+	DE_CROSSOVERS(ADD_ENGINES)
+#undef ADD_ENGINES
+}
+
+// The keys come from the same lists as those of the mutations, crossovers and deCHs registries
+EngineRegistry createEngines(){
+	EngineRegistry registry;
+#define ADD_ENGINES(KEY, X) addCrossoverEngines<X>(registry, #KEY);
+	DE_MUTATIONS(ADD_ENGINES)
+#undef ADD_ENGINES
+	return registry;
+}
+
+EngineRegistry const deEngines = createEngines();
@@ -5,52 +5,56 @@
 #include <algorithm>
 #include <pthread.h>
 
-DESuite::DESuite(){
+DESuite::DESuite() : space(4){
+	std::vector<std::string> mutationManagers, crossoverManagers, adaptationManagers, constraintHandlers;
 	for (auto&i : ::mutations)
-		this->mutationManagers.push_back(i.first);
+		mutationManagers.push_back(i.first);
 	for (auto&i : ::crossovers)
-		this->crossoverManagers.push_back(i.first);
+		crossoverManagers.push_back(i.first);
 	for (auto&i : ::deAdaptations)
-		this->adaptationManagers.push_back(i.first);
+		adaptationManagers.push_back(i.first);
 	for (auto&i : ::deCHs)
-		this->constraintHandlers.push_back(i.first);
+		if (!optInCHs.count(i.first))
+			constraintHandlers.push_back(i.first);
 
-	generateConfigurations();
+	setMutationManagers(mutationManagers);
+	setCrossoverManagers(crossoverManagers);
+	setDEAdaptationManagers(adaptationManagers);
+	setConstraintHandlers(constraintHandlers);
 }
 
-void DESuite::generateConfigurations(){
-	configurations.clear();
-	for (auto mutation : mutationManagers)
-		for (auto crossover : crossoverManagers)
-				for (auto adaptation : adaptationManagers)
-					for (auto ch : constraintHandlers)
-							configurations.push_back(DEConfig(mutation, crossover, adaptation, ch));
+DifferentialEvolution DESuite::create(std::vector<std::string> const& names) const {
+	return DifferentialEvolution(DEConfig(names[0], names[1], names[2], names[3]));
 }
 
 DifferentialEvolution DESuite::getDE(int const i) {
-	return DifferentialEvolution (configurations[i]);
+	return create(space.get(i));
+}
+
+DifferentialEvolution DESuite::getRandomDE() {
+	return create(space.sample());
 }
 
 void DESuite::setMutationManagers(std::vector<std::string> mutationManagers){
-	this->mutationManagers = mutationManagers;
-	generateConfigurations();
+	space.setComponent(0, mutationManagers);
 }
 
 void DESuite::setCrossoverManagers(std::vector<std::string> crossoverManagers){
-	this->crossoverManagers = crossoverManagers;
-	generateConfigurations();
+	space.setComponent(1, crossoverManagers);
 }
 
 void DESuite::setDEAdaptationManagers(std::vector<std::string> adaptationManagers){
-	this->adaptationManagers = adaptationManagers;
-	generateConfigurations();
+	space.setComponent(2, adaptationManagers);
 }
 
 void DESuite::setConstraintHandlers(std::vector<std::string> chs){
-	this->constraintHandlers = chs;
-	generateConfigurations();
+	space.setComponent(3, chs);
+}
+
+void DESuite::addFilter(ConfigurationSpace::Filter const filter){
+	space.addFilter(filter);
 }
 
 int DESuite::size() const {
-	return configurations.size();
+	return space.size();
 }
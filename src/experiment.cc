@@ -3,35 +3,31 @@
 #include "desuite.h"
 #include "psode2.h"
 #include "random_suite.h"
+#include "suiterunner.h"
 #include <sys/types.h>
+#include <thread>
 
-HybridAlgorithm* ha;
-ParticleSwarm* pso;
-DifferentialEvolution* de;
-PSODE2* psode2;
-
-void algorithm
-	(std::shared_ptr<IOHprofiler_problem<double>> problem,
-	std::shared_ptr<IOHprofiler_csv_logger> logger) {
-	int const D = problem->IOHprofiler_get_number_of_variables(); 
-	de->run(problem, logger, D*10000, 5 * D); 
-	//pso->run(problem, logger, D*10000, 10 * D, {}); 
+void algorithm(DifferentialEvolution& de, SuiteRunner::Problem const problem, SuiteRunner::CsvLogger const logger) {
+	int const D = problem->IOHprofiler_get_number_of_variables();
+	de.run(problem, logger, D*10000, 5 * D);
 }
 
-void _run_experiment(bool const log) {
+void _run_experiment(bool const log, int const evaluationThreads) {
 	static registerInFactory<IOHprofiler_suite<double>,Random_suite> regSuite("random");
-	de = new DifferentialEvolution(DEConfig("R1", "E", "S", "RS"));
-	std::string templateFile = "./configuration.ini";
-
-	std::string configFile = generateConfig(templateFile, de->getIdString());
-	IOHprofiler_experimenter<double> experimenter(configFile,algorithm); 
+	DESuite suite; // Narrow down or pass a list of configurations to add() to run a larger sweep
+	suite.setMutationManagers({"R1"});
+	suite.setCrossoverManagers({"E"});
+	suite.setDEAdaptationManagers({"S"});
+	suite.setConstraintHandlers({"RS"});
 
-	experimenter._set_independent_runs(1);
-	experimenter._run();
-	delete de;
+	int const threads = std::max(1, (int) std::thread::hardware_concurrency() / evaluationThreads);
+	SuiteRunner runner("./configuration.ini", threads, evaluationThreads);
+	runner.add(suite, algorithm);
+	runner.run(1);
 }
 
-int main(){
+int main(int argc, char **argv){
 	bool const log = false;
-	_run_experiment(log);
+	int const evaluationThreads = argc > 1 ? std::stoi(argv[1]) : 1; // Per run; the results do not depend on it
+	_run_experiment(log, evaluationThreads);
 }
@@ -0,0 +1,13 @@
+#include "generationarena.h"
+
+GenerationArena::GenerationArena(int const size, int const D)
+	: donors(size, D), trials(size, D){
+}
+
+std::vector<Solution*> const& GenerationArena::getDonors() const {
+	return donors.getSolutions();
+}
+
+std::vector<Solution*> const& GenerationArena::getTrials() const {
+	return trials.getSolutions();
+}
@@ -25,6 +25,12 @@ void Logger::log(std::vector<double> F, std::vector<double> Cr){
 	out << avgF << " " << avgCr << ","; 
 }
 
+void Logger::log(std::vector<int> const& histogram){
+	for (int count : histogram)
+		out << count << " ";
+	out << ",";
+}
+
 void Logger::newLine(){
 	out << "\n";
 }
@@ -32,3 +38,21 @@ void Logger::newLine(){
 Logger::~Logger(){
 	out.close();
 };
+
+void ResampleLogger::log(std::vector<int> const& histogram){
+	if (histogram.empty())
+		return;
+
+	if (!logger){
+		logger = new Logger(filename);
+		logger->start(function, D);
+	}
+	logger->log(histogram);
+}
+
+ResampleLogger::~ResampleLogger(){
+	if (logger){
+		logger->newLine();
+		delete logger;
+	}
+}
@@ -1,7 +1,10 @@
 #include <IOHprofiler_experimenter.h>
+#include <algorithm>
 #include <random>
 #include <set>
+#include <map>
 #include <mpi.h>
+#include <sys/stat.h>
 #include <fstream>
 #include "hybridalgorithm.h"
 #include "differentialevolution.h"
@@ -9,22 +12,137 @@
 #include "hybridsuite.h"
 #include "particleswarmsuite.h"
 #include "util.h"
+#include "rng.h"
 #include "random_suite.h"
+#include "batchproblem.h"
+
+// Rank 0 hands out (configuration, problem, instance, dimension, run) tasks to the other ranks on
+// request, so any number of ranks can run the sweep and ranks that finish early keep taking work.
+// Every task seeds its own random stream, so the results do not depend on which rank ran it.
+// Each rank writes to its own result folders, so no two ranks ever append to the same file.
+// A finished task leaves a marker next to its checkpoint, so a restarted sweep only runs the rest.
 
 DESuite suite;
+int const popSize = 100;
+int const independentRuns = 100;
+int const checkpointInterval = 100; // Generations between the checkpoints of a run
+int const REQUEST = 1, ASSIGN = 2; // Message tags
 
-void experiment
-	(std::shared_ptr<IOHprofiler_problem<double>> problem,
-		std::shared_ptr<IOHprofiler_csv_logger> logger) {
+struct Sweep {
+	IOHprofiler_configuration conf;
+	std::vector<int> problems, instances, dimensions;
 
-	int const D = problem->IOHprofiler_get_number_of_variables();
-	int const popSize = 100;
+	Sweep(std::string const configFile){
+		conf.readcfg(configFile);
+		problems = conf.get_problem_id();
+		instances = conf.get_instance_id();
+		dimensions = conf.get_dimension();
+	}
 
-	int id;
-	MPI_Comm_rank(MPI_COMM_WORLD, &id);
+	int size() const {
+		return suite.size() * problems.size() * instances.size() * dimensions.size() * independentRuns;
+	}
+};
+
+std::string taskFile(int const task, std::string const extension){
+	return "scratch/checkpoints/task" + std::to_string(task) + extension;
+}
+
+class Worker {
+	private:
+		Sweep const& sweep;
+		int const id;
+		int const evaluationThreads;
+		int loggerConfiguration;
+		std::shared_ptr<IOHprofiler_csv_logger> logger; // Of loggerConfiguration; tasks arrive in order, so only this one is open
+		std::shared_ptr<IOHprofiler_csv_logger> getLogger(int const configuration, std::string const name);
+	public:
+		Worker(Sweep const& sweep, int const id, int const evaluationThreads)
+			: sweep(sweep), id(id), evaluationThreads(evaluationThreads), loggerConfiguration(-1){};
+		void run(int task, uint64_t const seed);
+};
+
+std::shared_ptr<IOHprofiler_csv_logger> Worker::getLogger(int const configuration, std::string const name){
+	if (configuration == loggerConfiguration)
+		return logger;
+
+	IOHprofiler_configuration const& conf = sweep.conf;
+	logger.reset(); // Closes the files of the previous configuration
+	loggerConfiguration = configuration;
+	logger = std::make_shared<IOHprofiler_csv_logger>(conf.get_output_directory(),
+			name + "_rank" + std::to_string(id), name, conf.get_algorithm_info());
+	logger->set_complete_flag(conf.get_complete_triggers());
+	logger->set_interval(conf.get_number_interval_triggers());
+	logger->set_time_points(conf.get_base_evaluation_triggers(), conf.get_update_triggers());
+	logger->set_number_of_targets(conf.get_number_target_triggers());
+	logger->activate_logger();
+	logger->track_suite(conf.get_suite_name());
+	return logger;
+}
+
+void Worker::run(int task, uint64_t const seed){
+	rng.seed(seed, task);
+	std::string const checkpoint = taskFile(task, ".ckp");
+	std::string const done = taskFile(task, ".done");
+
+	task /= independentRuns; // The run index only selects the random stream
+	int const dimension = sweep.dimensions[task % sweep.dimensions.size()];
+	task /= sweep.dimensions.size();
+	int const instance = sweep.instances[task % sweep.instances.size()];
+	task /= sweep.instances.size();
+	int const problemId = sweep.problems[task % sweep.problems.size()];
+	int const configuration = task / sweep.problems.size();
+
+	std::shared_ptr<IOHprofiler_problem<double>> const problem =
+		loadSuiteProblem(sweep.conf.get_suite_name(), problemId, instance, dimension, evaluationThreads);
 
-	DifferentialEvolution de = suite.getDE(id);
-	de.run(problem, logger, D*10000, popSize);
+	DifferentialEvolution de = suite.getDE(configuration);
+	de.setLogSuffix("_rank" + std::to_string(id));
+	de.setEvaluationThreads(evaluationThreads);
+	de.setCheckpoint(checkpoint, checkpointInterval); // A preempted run resumes where it was when the sweep is started again
+	std::shared_ptr<IOHprofiler_csv_logger> const logger = getLogger(configuration, de.getIdString());
+	logger->track_problem(*problem);
+	de.run(problem, logger, dimension*10000, popSize);
+	std::ofstream(done) << seed << std::endl;
+}
+
+// The tasks without a completion marker
+std::vector<int> pendingTasks(Sweep const& sweep){
+	std::vector<int> pending;
+	for (int task = 0; task < sweep.size(); task++)
+		if (!std::ifstream(taskFile(task, ".done")))
+			pending.push_back(task);
+	return pending;
+}
+
+// Guided self-scheduling: large chunks while there is plenty of work, single tasks towards the end
+void dispatch(int const tasks, int const workers){
+	int next = 0;
+	int active = workers;
+	while (active > 0){
+		MPI_Status status;
+		int dummy;
+		MPI_Recv(&dummy, 1, MPI_INT, MPI_ANY_SOURCE, REQUEST, MPI_COMM_WORLD, &status);
+
+		int const chunk = std::max(1, (tasks - next) / (4 * workers));
+		int assignment[2] = {next, std::min(tasks, next + chunk)}; // Empty once all tasks are handed out
+		if (assignment[0] == assignment[1])
+			active--;
+		next = assignment[1];
+		MPI_Send(assignment, 2, MPI_INT, status.MPI_SOURCE, ASSIGN, MPI_COMM_WORLD);
+	}
+}
+
+void work(Worker& worker, std::vector<int> const& pending, uint64_t const seed){
+	while (true){
+		int request = 0, assignment[2];
+		MPI_Send(&request, 1, MPI_INT, 0, REQUEST, MPI_COMM_WORLD);
+		MPI_Recv(assignment, 2, MPI_INT, 0, ASSIGN, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+		if (assignment[0] == assignment[1])
+			break;
+		for (int i = assignment[0]; i < assignment[1]; i++)
+			worker.run(pending[i], seed);
+	}
 }
 
 int main(int argc, char **argv) {
@@ -33,17 +151,39 @@ int main(int argc, char **argv) {
 	suite.setCrossoverManagers({"E"});
 
 	std::string const templateFile = "./configuration.ini";
-	int id;
+	int id, ranks;
 	MPI_Init(&argc, &argv);
 	MPI_Comm_rank(MPI_COMM_WORLD, &id);
+	MPI_Comm_size(MPI_COMM_WORLD, &ranks);
+
+	unsigned long long seed = argc > 1 ? std::stoull(argv[1]) : rng.nextSeed(); // Rank 0 decides
+	MPI_Bcast(&seed, 1, MPI_UNSIGNED_LONG_LONG, 0, MPI_COMM_WORLD);
+	int const evaluationThreads = argc > 2 ? std::stoi(argv[2]) : 1; // Per rank; the results do not depend on it
+
+	Sweep const sweep(templateFile);
+	Worker worker(sweep, id, evaluationThreads);
+	mkdir("scratch", 0755); // Fails harmlessly if it exists
+	mkdir("scratch/checkpoints", 0755);
+
+	std::vector<int> pending; // Indexed by the assignments of dispatch()
+	int pendingSize = 0;
+	if (id == 0){
+		pending = pendingTasks(sweep);
+		pendingSize = pending.size();
+		std::cerr << "Scheduling " << pendingSize << " of " << sweep.size() << " runs on " << std::max(1, ranks - 1)
+			<< " workers, seed " << seed << std::endl;
+	}
+	MPI_Bcast(&pendingSize, 1, MPI_INT, 0, MPI_COMM_WORLD);
+	pending.resize(pendingSize);
+	MPI_Bcast(pending.data(), pendingSize, MPI_INT, 0, MPI_COMM_WORLD);
 
-	if (id < suite.size()){
-		std::string const configFile = generateConfig(templateFile, suite.getDE(id).getIdString());
-		IOHprofiler_experimenter<double> experimenter(configFile, experiment);
-		experimenter._set_independent_runs(100);
-		experimenter._run();
+	if (ranks == 1){
+		for (int const task : pending)
+			worker.run(task, seed);
+	} else if (id == 0){
+		dispatch(pendingSize, ranks - 1);
 	} else {
-		std::cerr << "Error: suite does not contain " << id << std::endl;
+		work(worker, pending, seed);
 	}
 
 	MPI_Finalize();
@@ -2,65 +2,82 @@
 #include "util.h"
 #include <limits>
 #include <numeric>
+#include <cmath>
+#include "simd.h"
+#include "checkpoint.h"
 
 #define LC(X) [](int const D, DEConstraintHandler* const ch){return new X(D,ch);}
 
 std::vector<Solution*> MutationManager::mutate(std::vector<Solution*>const& genomes, std::vector<double>const& Fs){
+	std::vector<Solution*> mutants(genomes.size());
+	for (unsigned int i = 0; i < genomes.size(); i++)
+		mutants[i] = new Solution(D);
+
+	mutate(genomes, Fs, mutants);
+	return mutants;
+}
+
+void MutationManager::prepare(std::vector<Solution*>const& genomes, std::vector<double>const& Fs){
 	this->genomes = genomes;
 	this->Fs = Fs;
 
 	preMutation(); // Some mutation managers use this to prepare some stuff
+}
 
-	std::vector<Solution*> mutants(genomes.size());
+void MutationManager::mutate(std::vector<Solution*>const& genomes, std::vector<double>const& Fs, std::vector<Solution*>const& mutants){
+	prepare(genomes, Fs);
 
-	for (unsigned int i = 0; i < genomes.size(); i++){
-		int resamples = 0;
-		while (true){
-			Solution* m = mutate(i);
-			if (!deCH->resample(m, resamples)){
-				deCH->repair(m); //generic repair
-				mutants[i] = m; 
-				break;
-			}
-			resamples++;
-			delete m;
-		}
-	}
-	return mutants;
+	std::vector<int> lanes(D); // Infeasible coordinates when resampling per coordinate
+	int* const redrawn = deCH->resamplesDimensions() ? lanes.data() : NULL;
+
+	for (unsigned int i = 0; i < genomes.size(); i++)
+		mutateFeasible([this, i](Solution* const m, Lanes const lanes){return mutate(i, m, lanes);},
+			*deCH, mutants[i], genomes[i], redrawn);
+	deCH->repairBatch(mutants); // Generic repair of all mutants at once
 }
 
+#define ENTRY(KEY, X) {#KEY, LC(X)},
 std::map<std::string, std::function<MutationManager* (int const, DEConstraintHandler*const)>> const mutations ({
-		{"R1", LC(Rand1MutationManager)},
-		{"T1", LC(TTB1MutationManager)},
-		{"T2", LC(TTB2MutationManager)},
-		{"P1", LC(TTPB1MutationManager)},
-		{"B1", LC(Best1MutationManager)},
-		{"B2", LC(Best2MutationManager)},
-		{"R2", LC(Rand2MutationManager)},
-		{"RD", LC(Rand2DirMutationManager)},
-		{"NS", LC(NSDEMutationManager)},
-		{"TR", LC(TrigonometricMutationManager)},
-		{"O1", LC(TwoOpt1MutationManager)},
-		{"O2", LC(TwoOpt2MutationManager)},
-		{"PX", LC(ProximityMutationManager)},
-		{"RA", LC(RankingMutationManager)},
+		DE_MUTATIONS(ENTRY)
 });
 
-// Rand/1
-Solution* Rand1MutationManager::mutate(int const i) const{
-	std::vector<Solution*> possibilities = genomes;
-	possibilities.erase(possibilities.begin() + i);
+void MutationManager::pickDistinct(int const i, Solution** const xr, int const k) const{
+	int const n = genomes.size();
+	int picked[8];
+	for (int j = 0; j < k; j++){
+		int r;
+		do {
+			r = rng.randInt(0, n-2);
+			if (r >= i) // Skip the target itself
+				r++;
+		} while (std::find(picked, picked + j, r) != picked + j);
+		picked[j] = r;
+		xr[j] = genomes[r];
+	}
+}
 
-	std::vector<Solution*> xr = pickRandom(possibilities, 3);
-	std::vector<double> mutant = xr[0]->getX();
-	std::vector<double> difference(D);
-	subtract(xr[1]->getX(), xr[2]->getX(), difference);
-	scale(difference, Fs[i]);
-	add(mutant,difference, mutant);
+void MutationManager::rank(bool const full){
+	int const size = genomes.size();
+	ranking.resize(size);
+	std::iota(ranking.begin(), ranking.end(), 0);
+
+	auto const better = [this](int const a, int const b){return genomes[a]->getFitness() < genomes[b]->getFitness();};
+	if (full)
+		std::sort(ranking.begin(), ranking.end(), better);
+	else
+		std::nth_element(ranking.begin(), ranking.begin() + (pBestCount(size)-1), ranking.end(), better);
+}
 
-	Solution* m = new Solution(mutant);
-	deCH->repairDE(m, xr[0], genomes[i]);
-	return m;
+Solution* MutationManager::getPBest() const {
+	return genomes[ranking[rng.randInt(0, pBestCount(genomes.size())-1)]];
+}
+
+// Rand/1
+Solution const* Rand1MutationManager::mutate(int const i, Solution* const m, Lanes const lanes) const{
+	Solution* xr[3];
+	pickDistinct(i, xr, 3);
+	addScaledDifference(xr[0]->getXView(), xr[1]->getXView(), xr[2]->getXView(), Fs[i], m->modifyX(), lanes);
+	return xr[0];
 }
 
 // Target-to-best/1
@@ -68,24 +85,12 @@ void TTB1MutationManager::preMutation(){
 	best = getBest(genomes);
 }
 
-Solution* TTB1MutationManager::mutate(int const i) const{
-	std::vector<Solution*> possibilities = genomes;
-	possibilities.erase(possibilities.begin() + i);
-
-	std::vector<double> mutant = genomes[i]->getX();
-	std::vector<double> difference(D);
-
-	std::vector<Solution*> xr = pickRandom(possibilities, 2);
-
-	subtract(best->getX(), genomes[i]->getX(), difference);
-	add(difference, xr[0]->getX(), difference);
-	subtract(difference, xr[1]->getX(), difference);
-	scale(difference,Fs[i]);
+Solution const* TTB1MutationManager::mutate(int const i, Solution* const m, Lanes const lanes) const{
+	Solution* xr[2];
+	pickDistinct(i, xr, 2);
 
-	add(mutant, difference, mutant);
-	Solution* m = new Solution(mutant);
-	deCH->repairDE(m, genomes[i], genomes[i]);
-	return m;
+	addScaledDifferences(genomes[i]->getXView(), best->getXView(), genomes[i]->getXView(), xr[0]->getXView(), xr[1]->getXView(), Fs[i], m->modifyX(), lanes);
+	return genomes[i];
 }
 
 // Target-to-best/2
@@ -93,51 +98,28 @@ void TTB2MutationManager::preMutation(){
 	best = getBest(genomes);
 }
 
-Solution* TTB2MutationManager::mutate(int const i) const{
-	std::vector<Solution*> possibilities = genomes;
-	possibilities.erase(possibilities.begin() + i);
+Solution const* TTB2MutationManager::mutate(int const i, Solution* const m, Lanes const lanes) const{
+	Solution* xr[4];
+	pickDistinct(i, xr, 4);
 
-	std::vector<double> mutant = genomes[i]->getX();
-	std::vector<double> difference(D);
-
-	std::vector<Solution*> xr = pickRandom(possibilities, 4);
-
-	subtract(best->getX(), genomes[i]->getX(), difference);
-	add(difference, xr[0]->getX(), difference);
-	subtract(difference, xr[1]->getX(), difference);
-	add(difference, xr[2]->getX(), difference);
-	subtract(difference, xr[3]->getX(), difference);
-	scale(difference,Fs[i]);
-
-	add(mutant, difference, mutant);
-
-	Solution* m = new Solution(mutant);
-	deCH->repairDE(m, genomes[i], genomes[i]);
-	return m;
+	addScaledDifferences(genomes[i]->getXView(), best->getXView(), genomes[i]->getXView(), xr[0]->getXView(), 
+		xr[1]->getXView(), xr[2]->getXView(), xr[3]->getXView(), Fs[i], m->modifyX(), lanes);
+	return genomes[i];
 }
 
 // Target-to-pbest/1
-Solution* TTPB1MutationManager::mutate(int const i) const{
-	Solution* pBest = getPBest(genomes); // pBest is sampled for each mutation
-
-	std::vector<Solution*> possibilities = genomes;
-	possibilities.erase(possibilities.begin() + i);
-
-	std::vector<double> mutant = genomes[i]->getX();
-	std::vector<double> difference(D);
-
-	std::vector<Solution*> xr = pickRandom(possibilities, 2);
+void TTPB1MutationManager::preMutation(){
+	rank(false);
+}
 
-	subtract(pBest->getX(), genomes[i]->getX(), difference);
-	add(difference, xr[0]->getX(), difference);
-	subtract(difference, xr[1]->getX(), difference);
-	scale(difference,Fs[i]);
+Solution const* TTPB1MutationManager::mutate(int const i, Solution* const m, Lanes const lanes) const{
+	Solution* pBest = getPBest(); // pBest is sampled for each mutation
 
-	add(mutant, difference, mutant);
+	Solution* xr[2];
+	pickDistinct(i, xr, 2);
 
-	Solution* m = new Solution(mutant);
-	deCH->repairDE(m, genomes[i], genomes[i]);
-	return m;
+	addScaledDifferences(genomes[i]->getXView(), pBest->getXView(), genomes[i]->getXView(), xr[0]->getXView(), xr[1]->getXView(), Fs[i], m->modifyX(), lanes);
+	return genomes[i];
 }
 
 // Best/1
@@ -145,22 +127,11 @@ void Best1MutationManager::preMutation(){
 	best = getBest(genomes);
 }
 
-Solution* Best1MutationManager::mutate(int const i) const{
-	std::vector<Solution*> possibilities = genomes;
-	possibilities.erase(possibilities.begin() + i);
-
-	std::vector<double> mutant = best->getX();
-	std::vector<double> difference(D);
-	
-	std::vector<Solution*> xr = pickRandom(possibilities, 2);
-	subtract(xr[0]->getX(), xr[1]->getX(), difference);
-
-	scale(difference, Fs[i]);
-	add(mutant, difference, mutant);
-
-	Solution* m = new Solution(mutant);
-	deCH->repairDE(m, best, genomes[i]);
-	return m;
+Solution const* Best1MutationManager::mutate(int const i, Solution* const m, Lanes const lanes) const{
+	Solution* xr[2];
+	pickDistinct(i, xr, 2);
+	addScaledDifference(best->getXView(), xr[0]->getXView(), xr[1]->getXView(), Fs[i], m->modifyX(), lanes);
+	return best;
 }
 
 // Best/2
@@ -168,51 +139,26 @@ void Best2MutationManager::preMutation(){
 	best = getBest(genomes);
 }
 
-Solution* Best2MutationManager::mutate(int const i) const{
-	std::vector<Solution*> possibilities = genomes;
-	possibilities.erase(possibilities.begin() + i);
-
-	std::vector<double> mutant = best->getX();
-	std::vector<double> difference(D);
-
-	std::vector<Solution*> xr = pickRandom(possibilities, 4);
-	subtract(xr[0]->getX(), xr[1]->getX(), difference);
-	add(difference, xr[2]->getX(), difference);
-	subtract(difference, xr[3]->getX(), difference);
-	scale(difference, Fs[i]);
-	add(mutant, difference, mutant);
-
-	Solution* m = new Solution(mutant);
-	deCH->repairDE(m, best, genomes[i]);
-	return m;
+Solution const* Best2MutationManager::mutate(int const i, Solution* const m, Lanes const lanes) const{
+	Solution* xr[4];
+	pickDistinct(i, xr, 4);
+	addScaledDifferences(best->getXView(), xr[0]->getXView(), xr[1]->getXView(), xr[2]->getXView(), xr[3]->getXView(), Fs[i], m->modifyX(), lanes);
+	return best;
 }
 
 // Rand/2
-Solution* Rand2MutationManager::mutate(int const i) const{
-	std::vector<Solution*> possibilities = genomes;
-	possibilities.erase(possibilities.begin() + i);
+Solution const* Rand2MutationManager::mutate(int const i, Solution* const m, Lanes const lanes) const{
+	Solution* xr[5];
+	pickDistinct(i, xr, 5);
 
-	std::vector<Solution*> xr = pickRandom(possibilities, 5);
-	std::vector<double> mutant = xr[4]->getX();
-	std::vector<double> difference(D);
-
-	subtract(xr[0]->getX(), xr[1]->getX(), difference);
-	add(difference, xr[2]->getX(), difference);
-	subtract(difference, xr[3]->getX(), difference);
-	scale(difference, Fs[i]);
-
-	add(mutant, difference, mutant);
-	Solution* m = new Solution(mutant);
-	deCH->repairDE(m, xr[4], genomes[i]);
-	return m;
+	addScaledDifferences(xr[4]->getXView(), xr[0]->getXView(), xr[1]->getXView(), xr[2]->getXView(), xr[3]->getXView(), Fs[i], m->modifyX(), lanes);
+	return xr[4];
 }
 
 // Rand/2/dir
-Solution* Rand2DirMutationManager::mutate(int const i) const{
-	std::vector<Solution*> possibilities = genomes;
-	possibilities.erase(possibilities.begin() + i);
-
-	std::vector<Solution*> xr = pickRandom(possibilities, 4);
+Solution const* Rand2DirMutationManager::mutate(int const i, Solution* const m, Lanes const lanes) const{
+	Solution* xr[4];
+	pickDistinct(i, xr, 4);
 
 	if (xr[1]->getFitness() < xr[0]->getFitness())
 		std::swap(xr[0], xr[1]);
@@ -220,31 +166,14 @@ Solution* Rand2DirMutationManager::mutate(int const i) const{
 	if (xr[3]->getFitness() < xr[2]->getFitness())
 		std::swap(xr[2], xr[3]);
 
-	std::vector<double> mutant = xr[0]->getX();
-
-	std::vector<double> difference(D);
-	subtract(xr[0]->getX(), xr[1]->getX(), difference);
-	add(difference, xr[2]->getX(), difference);
-	subtract(difference, xr[3]->getX(), difference);
-	scale(difference, Fs[i]/2.);
-
-	add(mutant, difference, mutant);
-
-	Solution* m = new Solution(mutant);
-	deCH->repairDE(m, xr[0], genomes[i]);
-	return m;
+	addScaledDifferences(xr[0]->getXView(), xr[0]->getXView(), xr[1]->getXView(), xr[2]->getXView(), xr[3]->getXView(), Fs[i]/2., m->modifyX(), lanes);
+	return xr[0];
 }
 
 // NSDE
-Solution* NSDEMutationManager::mutate(int const i) const {
-	std::vector<Solution*> possibilities = genomes;
-	possibilities.erase(possibilities.begin() + i);
-
-	std::vector<Solution*> xr = pickRandom(possibilities, 3);
-	std::vector<double> mutant = xr[0]->getX(); 
-
-	std::vector<double> difference(D);
-	subtract(xr[1]->getX(), xr[2]->getX(), difference);
+Solution const* NSDEMutationManager::mutate(int const i, Solution* const m, Lanes const lanes) const{
+	Solution* xr[3];
+	pickDistinct(i, xr, 3);
 
 	double randomVar;
 	if (rng.randDouble(0,1) < 0.5)
@@ -252,25 +181,21 @@ Solution* NSDEMutationManager::mutate(int const i) const {
 	else 
 		randomVar = rng.cauchyDistribution(0,1);
 
-	scale(difference, randomVar);
-
-	add(mutant, difference, mutant);
-
-	Solution* m = new Solution(mutant);
-	deCH->repairDE(m, xr[0], genomes[i]);
-	return m;
+	addScaledDifference(xr[0]->getXView(), xr[1]->getXView(), xr[2]->getXView(), randomVar, m->modifyX(), lanes);
+	return xr[0];
 }
 
 // Trigonometric
-Solution* TrigonometricMutationManager::mutate(int const i) const{
-	return rng.randDouble(0,1) <= gamma ? trigonometricMutation(i) : rand1Mutation(i);
+Solution const* TrigonometricMutationManager::mutate(int const i, Solution* const m, Lanes const lanes) const{
+	if (rng.randDouble(0,1) <= gamma)
+		return trigonometricMutation(i, m, lanes);
+	else 
+		return rand1Mutation(i, m, lanes);
 }
 
-Solution* TrigonometricMutationManager::trigonometricMutation(int const i) const{
-	std::vector<Solution*> possibilities = genomes;
-	possibilities.erase(possibilities.begin() + i);
-	
-	std::vector<Solution*> xr = pickRandom(possibilities, 3);
+Solution const* TrigonometricMutationManager::trigonometricMutation(int const i, Solution* const m, Lanes const lanes) const{
+	Solution* xr[3];
+	pickDistinct(i, xr, 3);
 
 	double const pPrime = std::abs(xr[0]->getFitness()) + std::abs(xr[1]->getFitness()) 
 					+ std::abs(xr[2]->getFitness());
@@ -279,186 +204,243 @@ Solution* TrigonometricMutationManager::trigonometricMutation(int const i) const
 	double const p1 = std::abs(xr[1]->getFitness()) / pPrime;
 	double const p2 = std::abs(xr[2]->getFitness()) / pPrime;
 
-	std::vector<double> mutant(D);
-
-	add(xr[0]->getX(), xr[1]->getX(), mutant);
-	add(mutant, xr[2]->getX(), mutant);
-	scale(mutant, 1./3.);
-
-	Solution base = Solution(mutant); // only used for correction strategies
+	if (lanes.all()){
+		add(xr[0]->getXView(), xr[1]->getXView(), mutant);
+		add(mutant, xr[2]->getXView(), mutant);
+		scale(mutant, 1./3.);
+		base.setX(mutant); // only used for correction strategies, which do not resample per coordinate
+	} else {
+		ConstSpan const a = xr[0]->getXView(), b = xr[1]->getXView(), c = xr[2]->getXView();
+		lanes.forEach(D, [&](int const j){mutant[j] = ((a[j] + b[j]) + c[j]) * (1./3.);});
+	}
 
-	std::vector<double> temp(D);
-	subtract(xr[0]->getX(), xr[1]->getX(), temp);
-	scale(temp, p1-p0);
-	add(temp, mutant, mutant);
+	addScaledDifference(mutant, xr[0]->getXView(), xr[1]->getXView(), p1-p0, mutant.data(), lanes);
+	addScaledDifference(mutant, xr[1]->getXView(), xr[2]->getXView(), p2-p1, mutant.data(), lanes);
+	addScaledDifference(mutant, xr[2]->getXView(), xr[0]->getXView(), p0-p2, m->modifyX(), lanes);
+	return &base;
+}
 
-	subtract(xr[1]->getX(), xr[2]->getX(), temp);
-	scale(temp, p2-p1);
-	add(temp, mutant, mutant);
+Solution const* TrigonometricMutationManager::rand1Mutation(int const i, Solution* const m, Lanes const lanes) const{
+	Solution* xr[3];
+	pickDistinct(i, xr, 3);
 
-	subtract(xr[2]->getX(), xr[0]->getX(), temp);
-	scale(temp, p0-p2);
-	add(temp, mutant, mutant);
-	
-	Solution* m = new Solution(mutant);
-	deCH->repairDE(m, &base, genomes[i]);
-	return m;
+	addScaledDifference(xr[0]->getXView(), xr[1]->getXView(), xr[2]->getXView(), Fs[i], m->modifyX(), lanes);
+	return xr[0];
 }
 
-Solution* TrigonometricMutationManager::rand1Mutation(int const i) const{
-	std::vector<Solution*> possibilities = genomes;
-	possibilities.erase(possibilities.begin() + i);
-	
-	std::vector<Solution*> xr = pickRandom(possibilities, 3);
+// Two-opt/1
+Solution const* TwoOpt1MutationManager::mutate(int const i, Solution* const m, Lanes const lanes) const{
+	Solution* xr[3];
+	pickDistinct(i, xr, 3);
 
-	std::vector<double> mutant = xr[0]->getX();
-	std::vector<double> difference(D);
-	subtract(xr[1]->getX(), xr[2]->getX(), difference);
-	scale(difference, Fs[i]);
-	add(mutant,difference, mutant);
+	if (xr[1]->getFitness() < xr[0]->getFitness())
+		std::swap(xr[0], xr[1]);
 
-	Solution* m = new Solution(mutant);
-	deCH->repairDE(m, xr[0], genomes[i]);
-	return m;
+	addScaledDifference(xr[0]->getXView(), xr[1]->getXView(), xr[2]->getXView(), Fs[i], m->modifyX(), lanes);
+	return xr[0];
 }
 
-// Two-opt/1
-Solution* TwoOpt1MutationManager::mutate(int const i) const{
-	std::vector<Solution*> possibilities = genomes;
-	possibilities.erase(possibilities.begin() + i);
-
-	std::vector<Solution*> xr = pickRandom(possibilities, 3);
+// Two-opt/2
+Solution const* TwoOpt2MutationManager::mutate(int const i, Solution* const m, Lanes const lanes) const{
+	Solution* xr[5];
+	pickDistinct(i, xr, 5);
 
 	if (xr[1]->getFitness() < xr[0]->getFitness())
 		std::swap(xr[0], xr[1]);
 
-	std::vector<double> mutant = xr[0]->getX();
-	std::vector<double> difference(D);
-	subtract(xr[1]->getX(), xr[2]->getX(), difference);
-	scale(difference, Fs[i]);
-	add(mutant,difference, mutant);
+	addScaledDifferences(xr[0]->getXView(), xr[1]->getXView(), xr[2]->getXView(), xr[3]->getXView(), xr[4]->getXView(), Fs[i], m->modifyX(), lanes);
+	return xr[0];
+}
 
-	Solution* m = new Solution(mutant);
-	deCH->repairDE(m, xr[0], genomes[i]);
-	return m;
+// Proximity-based Rand/1
+int ProximityMutationManager::packedIndex(int const i, int const j) const {
+	int const a = std::min(i,j), b = std::max(i,j);
+	return a * (2 * size - a - 1) / 2 + (b - a - 1);
 }
 
-// Two-opt/2
-Solution* TwoOpt2MutationManager::mutate(int const i) const{
-	std::vector<Solution*> possibilities = genomes;
-	possibilities.erase(possibilities.begin() + i);
+double ProximityMutationManager::weight(int const i, int const j) const {
+	return i == j ? 0. : weights[packedIndex(i, j)];
+}
 
-	std::vector<Solution*> xr = pickRandom(possibilities, 5);
+void ProximityMutationManager::buildRow(int const row){
+	double* const tree = &trees[row * size];
+	for (int j = 0; j < size; j++)
+		tree[j] = weight(row, j);
 
-	if (xr[1]->getFitness() < xr[0]->getFitness())
-		std::swap(xr[0], xr[1]);
+	for (int k = 1; k <= size; k++){ // Linear time Fenwick construction
+		int const parent = k + (k & -k);
+		if (parent <= size)
+			tree[parent-1] += tree[k-1];
+	}
+}
 
-	std::vector<double> mutant = xr[0]->getX();
-	std::vector<double> difference(D);
+void ProximityMutationManager::addToRow(int const row, int const j, double const delta){
+	double* const tree = &trees[row * size];
+	for (int k = j+1; k <= size; k += k & -k)
+		tree[k-1] += delta;
+}
 
-	subtract(xr[1]->getX(), xr[2]->getX(), difference);
-	add(difference, xr[3]->getX(), difference);
-	subtract(difference, xr[4]->getX(), difference);
-	scale(difference, Fs[i]);
+double ProximityMutationManager::prefix(int const row, int const j) const {
+	double const* const tree = &trees[row * size];
+	double sum = 0.;
+	for (int k = j; k > 0; k -= k & -k)
+		sum += tree[k-1];
+	return sum;
+}
 
-	add(mutant, difference, mutant);
+double ProximityMutationManager::rowTotal(int const row) const {
+	return prefix(row, size);
+}
 
-	Solution* m = new Solution(mutant);
-	deCH->repairDE(m, xr[0], genomes[i]);
-	return m;
+int ProximityMutationManager::findInRow(int const row, double target) const {
+	double const* const tree = &trees[row * size];
+	int step = 1;
+	while (step * 2 <= size)
+		step *= 2;
+
+	int pos = 0;
+	for (; step > 0; step /= 2){
+		if (pos + step <= size && tree[pos + step - 1] <= target){
+			pos += step;
+			target -= tree[pos-1];
+		}
+	}
+	return std::min(pos, size-1); // Guard against rounding in the partial sums
 }
 
-// Proximity-based Rand/1
 void ProximityMutationManager::preMutation(){
-	int const size = genomes.size();
-	//Initialize the matrices
-	if (Rp.empty()){
-		Rp.resize(size, std::vector<double>(size, 0.));
-		Rd.resize(size, std::vector<double>(size, 0.));
+	if (size != int(genomes.size())){
+		size = genomes.size();
+		cachedX.assign(size * D, std::numeric_limits<double>::quiet_NaN()); // Marks every genome as changed
+		weights.assign(size * (size-1) / 2, 0.);
+		trees.assign(size * size, 0.);
+		generationsSinceRebuild = std::numeric_limits<int>::max();
 	}
 
-	// Fill distance matrix
-	std::vector<double> rowTotals(size, 0.);
-	for (int i = 0; i < size-1; i++){
-		for (int j = i+1; j < size; j++){
-			double const dist = std::max(distance(genomes[i], genomes[j]), 1.0e-12);
-			Rd[i][j] = dist; Rd[j][i] = dist;
-			rowTotals[i] += dist; rowTotals[j] += dist;
+	// Find the genomes that were replaced in the last selection
+	std::vector<int> changed;
+	std::vector<bool> isChanged(size, false);
+	for (int i = 0; i < size; i++){
+		double const* const x = genomes[i]->getXView().data();
+		if (!std::equal(x, x + D, &cachedX[i * D])){
+			std::copy(x, x + D, &cachedX[i * D]);
+			changed.push_back(i);
+			isChanged[i] = true;
 		}
 	}
 
-	// Fill probability matrix
-	for (int i = 0; i < size; i++){
+	// Updating a column costs log(size) per row, rebuilding all rows costs size per row.
+	// Full rebuilds also reset rounding errors in the trees.
+	bool const rebuild = changed.size() * std::log2(size) > size || generationsSinceRebuild >= 100;
+
+	for (int const c : changed){
+		double const* const xc = &cachedX[c * D];
 		for (int j = 0; j < size; j++){
-			double const prob = i==j ? 0. : 1. / (Rd[i][j] / rowTotals[i]);
-			Rp[i][j] = prob;
+			if (j == c || (isChanged[j] && j < c)) // Pairs of changed genomes are done once
+				continue;
+
+			double const dist = std::max(std::sqrt(kernels->squaredDistance(xc, &cachedX[j * D], D)), 1.0e-12);
+			double& w = weights[packedIndex(c, j)];
+			if (!rebuild && !isChanged[j])
+				addToRow(j, c, 1./dist - w);
+			w = 1./dist;
 		}
 	}
+
+	if (rebuild){
+		for (int i = 0; i < size; i++)
+			buildRow(i);
+		generationsSinceRebuild = 0;
+	} else {
+		for (int const c : changed)
+			buildRow(c);
+		generationsSinceRebuild++;
+	}
 }
 
-Solution* ProximityMutationManager::mutate(int const i) const{
-	std::vector<Solution*> possibilities = genomes;
-	possibilities.erase(possibilities.begin() + i);
+void ProximityMutationManager::save(CheckpointWriter& writer) const {
+	writer.write<int32_t>(size);
+	writer.write<int32_t>(generationsSinceRebuild);
+	writer.write(cachedX);
+	writer.write(weights);
+	writer.write(trees);
+}
 
-	std::vector<double> prob = Rp[i];
-	prob.erase(prob.begin() + i); // Remove own probability
-	std::vector<Solution*> xr = rouletteSelect(possibilities, prob, 3);
+void ProximityMutationManager::load(CheckpointReader& reader){
+	int32_t rows, generations;
+	reader.read(rows);
+	reader.read(generations);
+	size = rows;
+	generationsSinceRebuild = generations;
+	reader.read(cachedX);
+	reader.read(weights);
+	reader.read(trees);
+}
 
-	std::vector<double> mutant = xr[0]->getX();
-	std::vector<double> difference(D);
-	subtract(xr[1]->getX(), xr[2]->getX(), difference);
-	scale(difference, Fs[i]);
-	add(mutant,difference, mutant);
+Solution const* ProximityMutationManager::mutate(int const i, Solution* const m, Lanes const lanes) const{
+	Solution* xr[3];
+	int picked[3];
+	double const total = rowTotal(i);
+	for (int k = 0; k < 3; k++){ // Roulette selection without replacement, the tree is left as it is
+		int sorted[3]; // Picked genomes by position in the row
+		std::copy(picked, picked + k, sorted);
+		std::sort(sorted, sorted + k);
+
+		double removed = 0.;
+		for (int p = 0; p < k; p++)
+			removed += weight(i, sorted[p]);
+
+		// A target on the remaining weights is moved past the intervals of the picked genomes. Rounding
+		// can still land on one of them or on the zero weight of i, so such picks are redrawn.
+		int pick;
+		do {
+			double target = rng.randDouble(0., total - removed);
+			for (int p = 0; p < k; p++)
+				if (target >= prefix(i, sorted[p]))
+					target += weight(i, sorted[p]);
+			pick = findInRow(i, target);
+		} while (pick == i || std::find(picked, picked + k, pick) != picked + k);
+
+		picked[k] = pick;
+		xr[k] = genomes[pick];
+	}
 
-	Solution* m = new Solution(mutant);
-	deCH->repairDE(m, xr[0], genomes[i]);
-	return m;
+	addScaledDifference(xr[0]->getXView(), xr[1]->getXView(), xr[2]->getXView(), Fs[i], m->modifyX(), lanes);
+	return xr[0];
 }
 
 // Ranking based
 void RankingMutationManager::preMutation(){
 	int const size = genomes.size();
-	probability.clear();
-
-	std::vector<Solution*> sorted = genomes;
-	sortOnFitness(sorted);
+	rank(true);
 
+	probability.resize(size);
 	for (int i = 0; i < size; i++)
-		probability[sorted[i]] = double(size - (i+1)) / double(size);
+		probability[ranking[i]] = double(size - (i+1)) / double(size);
 }
 
-Solution* RankingMutationManager::pickRanked(std::vector<Solution*>& possibilities) const{
+int RankingMutationManager::pickRanked(int const i) const{
 	int index;
 	do {
-		index = rng.randInt(0, possibilities.size()-1);
-	} while (rng.randDouble(0,1) > probability.at(possibilities[index]));
-
-	Solution* const pick = possibilities[index];
-	possibilities.erase(possibilities.begin() + index);
-	return pick;
+		index = rng.randInt(0, genomes.size()-2);
+		if (index >= i) // Skip the target itself
+			index++;
+	} while (rng.randDouble(0,1) > probability[index]);
+	return index;
 }
 
-Solution* RankingMutationManager::mutate(int const i) const{
-	Solution* pBest = getPBest(genomes); // pBest is sampled for each mutation
+Solution const* RankingMutationManager::mutate(int const i, Solution* const m, Lanes const lanes) const{
+	Solution* pBest = getPBest(); // pBest is sampled for each mutation
 
-	std::vector<Solution*> possibilities = genomes;
-	possibilities.erase(possibilities.begin() + i);
-
-	std::vector<double> mutant = genomes[i]->getX();
-	std::vector<double> difference(D);
-
-	Solution* xr0 = pickRanked(possibilities); // N.B. Ranked instead of Random
-
-	Solution* xr1 = pickRandom(possibilities);
-
-	subtract(pBest->getX(), genomes[i]->getX(), difference);
-	add(difference, xr0->getX(), difference);
-	subtract(difference, xr1->getX(), difference);
-	scale(difference,Fs[i]);
+	int const r0 = pickRanked(i); // N.B. Ranked instead of Random
+	int r1;
+	do {
+		r1 = rng.randInt(0, genomes.size()-1);
+	} while (r1 == i || r1 == r0);
 
-	add(mutant, difference, mutant);
+	Solution* const xr0 = genomes[r0];
+	Solution* const xr1 = genomes[r1];
 
-	Solution* m = new Solution(mutant);
-	deCH->repairDE(m, genomes[i], genomes[i]);
-	return m;
+	addScaledDifferences(genomes[i]->getXView(), pBest->getXView(), genomes[i]->getXView(), xr0->getXView(), xr1->getXView(), Fs[i], m->modifyX(), lanes);
+	return genomes[i];
 }
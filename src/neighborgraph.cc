@@ -0,0 +1,100 @@
+#include "neighborgraph.h"
+#include "rng.h"
+#include "checkpoint.h"
+#include <algorithm>
+
+NeighborGraph::NeighborGraph(int const size)
+	: size(size), words((size + 63) / 64), bits(size * words, 0){
+}
+
+int NeighborGraph::getSize() const {
+	return size;
+}
+
+bool NeighborGraph::isNeighbor(int const i, int const j) const {
+	return (bits[i * words + j / 64] >> (j % 64)) & 1;
+}
+
+void NeighborGraph::addNeighbor(int const i, int const j){
+	if (i != j) // E.g. a Von Neumann grid of one row would make every particle its own neighbor
+		bits[i * words + j / 64] |= uint64_t(1) << (j % 64);
+}
+
+void NeighborGraph::removeNeighbor(int const i, int const j){
+	bits[i * words + j / 64] &= ~(uint64_t(1) << (j % 64));
+}
+
+void NeighborGraph::removeAllNeighbors(){
+	std::fill(bits.begin(), bits.end(), 0);
+}
+
+void NeighborGraph::connectAll(){
+	uint64_t const lastWord = size % 64 == 0 ? ~uint64_t(0) : (uint64_t(1) << (size % 64)) - 1;
+	for (int i = 0; i < size; i++){
+		std::fill(&bits[i * words], &bits[i * words] + words - 1, ~uint64_t(0));
+		bits[i * words + words - 1] = lastWord;
+		removeNeighbor(i, i);
+	}
+}
+
+std::vector<int> NeighborGraph::collectRow(int const i, bool const set) const {
+	std::vector<int> row;
+	for (int w = 0; w < words; w++){
+		uint64_t word = set ? bits[i * words + w] : ~bits[i * words + w];
+		while (word != 0){
+			int const j = w * 64 + __builtin_ctzll(word);
+			word &= word - 1;
+			if (j >= size)
+				break;
+			if (j != i)
+				row.push_back(j);
+		}
+	}
+	return row;
+}
+
+void NeighborGraph::addRandomNeighbors(int const i, int const k){
+	std::vector<int> candidates = collectRow(i, false);
+	int const n = std::min(k, int(candidates.size()));
+	for (int c = 0; c < n; c++){ // Partial Fisher-Yates shuffle
+		std::swap(candidates[c], candidates[rng.randInt(c, candidates.size()-1)]);
+		addNeighbor(i, candidates[c]);
+	}
+}
+
+void NeighborGraph::removeRandomNeighbors(int const i, int const k, std::function<bool(int const)> const& keep){
+	std::vector<int> candidates = collectRow(i, true);
+	candidates.erase(std::remove_if(candidates.begin(), candidates.end(), keep), candidates.end());
+	int const n = std::min(k, int(candidates.size()));
+	for (int c = 0; c < n; c++){
+		std::swap(candidates[c], candidates[rng.randInt(c, candidates.size()-1)]);
+		removeNeighbor(i, candidates[c]);
+	}
+}
+
+int NeighborGraph::getNumberOfNeighbors(int const i) const {
+	int count = 0;
+	for (int w = 0; w < words; w++)
+		count += __builtin_popcountll(bits[i * words + w]);
+	return count;
+}
+
+void NeighborGraph::save(CheckpointWriter& writer) const {
+	writer.write(bits);
+}
+
+void NeighborGraph::load(CheckpointReader& reader){
+	reader.readInPlace(bits);
+}
+
+Neighborhood::Neighborhood()
+	: graph(NULL), particles(NULL), index(0){
+}
+
+Neighborhood::Neighborhood(NeighborGraph const* const graph, std::vector<Particle*> const* const particles, int const index)
+	: graph(graph), particles(particles), index(index){
+}
+
+int Neighborhood::size() const {
+	return graph == NULL ? 0 : graph->getNumberOfNeighbors(index);
+}
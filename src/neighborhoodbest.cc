@@ -0,0 +1,77 @@
+#include "neighborhoodbest.h"
+#include "population.h"
+#include "topologymanager.h"
+#include "threadpool.h"
+#include "checkpoint.h"
+
+NeighborhoodBest::NeighborhoodBest(Population& population, TopologyManager const& topology)
+	: population(population), topology(topology), holder(population.size, -1), globalHolder(-1){
+}
+
+void NeighborhoodBest::update(ThreadPool* const pool){
+	if (topology.isGlobal())
+		updateGlobal();
+	else if (pool)
+		pool->parallelFor(population.size, [this](int const i){updateParticle(i);});
+	else
+		for (int i = 0; i < population.size; i++)
+			updateParticle(i);
+}
+
+void NeighborhoodBest::updateGlobal(){
+	int best = globalHolder == -1 ? 0 : globalHolder; // The current holder wins ties
+	for (int i = 0; i < population.size; i++)
+		if (population.getPbest(i) < population.getPbest(best))
+			best = i;
+
+	globalHolder = best;
+	double const* const position = population.getP(best);
+	double const value = population.getPbest(best);
+	for (Particle* const p : population.getParticles())
+		p->followBest(position, value);
+}
+
+void NeighborhoodBest::updateParticle(int const i){
+	Particle* const particle = population.getParticle(i);
+	NeighborGraph const& graph = topology.getGraph();
+
+	int best = -1;
+	double bestScore = particle->getGbest();
+	if (holder[i] != -1 && population.getPbest(holder[i]) < bestScore){ // The current holder wins ties
+		best = holder[i];
+		bestScore = population.getPbest(best);
+	}
+
+	if (population.getPbest(i) < bestScore){
+		best = i;
+		bestScore = population.getPbest(i);
+	}
+
+	graph.forEachNeighbor(i, [&](int const j){
+		if (population.getPbest(j) < bestScore){
+			best = j;
+			bestScore = population.getPbest(j);
+		}
+	});
+
+	if (best == -1)
+		return;
+
+	if (topology.isStatic()){
+		holder[i] = best;
+		particle->followBest(population.getP(best), bestScore);
+	} else
+		particle->copyBest(population.getP(best), bestScore);
+}
+
+void NeighborhoodBest::save(CheckpointWriter& writer) const {
+	writer.write(holder);
+	writer.write<int32_t>(globalHolder);
+}
+
+void NeighborhoodBest::load(CheckpointReader& reader){
+	reader.readInPlace(holder);
+	int32_t global;
+	reader.read(global);
+	globalHolder = global;
+}
@@ -2,6 +2,7 @@
 #include "particleupdatesettings.h"
 #include "particleupdatemanager.h"
 #include "util.h"
+#include "population.h"
 #include "rng.h"
 #include <iostream>
 #include <algorithm>
@@ -12,23 +13,34 @@
 #include <IOHprofiler_experimenter.h>
 
 Particle::Particle(int const D, ParticleUpdateSettings const*const settings)
-	: Solution(D), v(D), p(D), g(D), pbest(std::numeric_limits<double>::max()), gbest(std::numeric_limits<double>::max()),
+	: Solution(D), ownState(3 * D), ownPbest(std::numeric_limits<double>::max()), ownGbest(std::numeric_limits<double>::max()),
+		v(&ownState[0]), p(&ownState[D]), g(&ownState[2 * D]), best(g), pbest(&ownPbest), gbest(&ownGbest), backup(2 * D), lanes(D),
 		settings(settings), psoCH(settings->psoCH){
-	particleUpdateManager = updateManagers.at(settings->managerType)(x,v,p,g,settings->parameters,neighborhood);
+	particleUpdateManager = updateManagers.at(settings->managerType)(x,v,p,best,D,settings->parameters,neighborhood);
+}
+
+Particle::Particle(Population& population, int const i, ParticleUpdateSettings const*const settings)
+	: Solution(population, i), ownPbest(std::numeric_limits<double>::max()), ownGbest(std::numeric_limits<double>::max()),
+		v(population.getV(i)), p(population.getP(i)), g(population.getG(i)), best(g), pbest(&population.pbest[i]), gbest(&population.gbest[i]), backup(2 * D), lanes(D),
+		settings(settings), psoCH(settings->psoCH){
+	particleUpdateManager = updateManagers.at(settings->managerType)(x,v,p,best,D,settings->parameters,neighborhood);
 }
 
 Particle::Particle(Particle const & other)
-	: Solution(other.D), v(other.v), p(other.p), g(other.g),
-	pbest(other.pbest), gbest(other.gbest), 
+	: Solution(other), ownState(other.ownState), ownPbest(*other.pbest), ownGbest(*other.gbest),
+	v(other.v), p(other.p), g(other.g), best(other.best), pbest(other.pbest), gbest(other.gbest), backup(2 * D), lanes(D),
 	neighborhood(other.neighborhood), particleUpdateManager(NULL),
 	settings(other.settings), psoCH(other.psoCH){
 
-	x = other.x;
-	evaluated=other.evaluated;
-	fitness = other.fitness;
+	if (!ownState.empty()){ // Copy of an owning particle
+		v = &ownState[0]; p = &ownState[D]; g = &ownState[2 * D];
+		if (other.best == other.g)
+			best = g;
+		pbest = &ownPbest; gbest = &ownGbest;
+	}
 
 	if (settings != NULL) // This constructor is used also by DE
-		particleUpdateManager = updateManagers.at(settings->managerType)(x,v,p,g,settings->parameters,neighborhood);
+		particleUpdateManager = updateManagers.at(settings->managerType)(x,v,p,best,D,settings->parameters,neighborhood);
 }
 
 Particle::~Particle(){
@@ -37,59 +49,68 @@ Particle::~Particle(){
 }
 
 std::vector<double> Particle::getV() const {
-	return v;
+	return std::vector<double>(v, v + D);
+}
+
+ConstSpan Particle::getVView() const {
+	return ConstSpan(v, D);
 }
 
 double Particle::getV(int const dim) const {
 	return v[dim];
 }
 
-void Particle::setV(std::vector<double> v){
-	this->v = v;
+void Particle::setV(std::vector<double> const& v){
+	std::copy(v.begin(), v.end(), this->v);
 }
 
 void Particle::setV(int const dim, double val){
 	this->v[dim] = val;
 }
 
-void Particle::addNeighbor(Particle* const neighbor){
-	neighborhood.push_back(neighbor);
-}
-
-void Particle::removeNeighbor(Particle* const neighbor){
-	neighborhood.erase(std::remove(neighborhood.begin(), neighborhood.end(), neighbor), neighborhood.end());
-}
-
-void Particle::removeAllNeighbors(){
-	neighborhood.clear();
+void Particle::setNeighborhood(Neighborhood const& neighborhood){
+	this->neighborhood = neighborhood;
 }
 
 void Particle::updateVelocityAndPosition(double progress){
 	evaluated = false;
-	std::vector<double> const oldV = v;
-	std::vector<double> const oldX = x;
-	int resamples = 0;
+	std::copy(x, x + D, backup.begin());
+	std::copy(v, v + D, backup.begin() + D);
 
-	while(true){
-		particleUpdateManager->updateVelocity(progress);
+	if (psoCH->resamplesDimensions()){ // Only the infeasible coordinates move again, from where they were
+		particleUpdateManager->updateVelocity(progress, Lanes());
 		psoCH->repairVelocityPre(this);
-		particleUpdateManager->updatePosition();
-		if (psoCH->resample(this, resamples)){
-			x = oldX; // reset position and velocity
-			v = oldV;
+		particleUpdateManager->updatePosition(Lanes());
+		redrawViolations(*psoCH, x, lanes.data(), [&](Lanes const redrawn){
+			redrawn.forEach(D, [&](int const j){
+				x[j] = backup[j];
+				v[j] = backup[D + j];
+			});
+			particleUpdateManager->updateVelocity(progress, redrawn);
+			particleUpdateManager->updatePosition(redrawn);
+		});
+	} else {
+		int resamples = 0;
+		while(true){
+			particleUpdateManager->updateVelocity(progress, Lanes());
+			psoCH->repairVelocityPre(this);
+			particleUpdateManager->updatePosition(Lanes());
+			if (!psoCH->resample(this, resamples))
+				break;
+			std::copy(backup.begin(), backup.begin() + D, x); // reset position and velocity
+			std::copy(backup.begin() + D, backup.end(), v);
 			resamples++;
-		} else 
-			break;
+		}
 	}
 	psoCH->repair(this); // Generic repair
 }
 
 double Particle::getGbest() const {
-	return gbest;
+	return *gbest;
 }
 
 double Particle::getPbest() const {
-	return pbest;
+	return *pbest;
 }
 
 double Particle::getP(int const i) const {
@@ -97,53 +118,69 @@ double Particle::getP(int const i) const {
 }
 
 std::vector<double> Particle::getG() const {
-	return g;
+	return std::vector<double>(best, best + D);
+}
+
+ConstSpan Particle::getGView() const {
+	return ConstSpan(best, D);
 }
 
 std::vector<double> Particle::getP() const {
-	return p;
+	return std::vector<double>(p, p + D);
 }
 
-void Particle::updateGbest(){
-	int bestNeighbor = -1;
+ConstSpan Particle::getPView() const {
+	return ConstSpan(p, D);
+}
 
-	if (fitness < gbest){ // First check own fitness
-		gbest = fitness;
-		g = x;
+Particle const* Particle::findBestNeighbor(){
+	if (*fitness < *gbest){ // First check own fitness
+		*gbest = *fitness;
+		std::copy(x, x + D, g);
 	}
 
-	double bestScore = gbest;
-	for (unsigned int i = 0; i < neighborhood.size(); i++){ // Check neighbors fitness
-		double const currentScore = neighborhood[i]->getPbest();
+	Particle const* bestNeighbor = NULL;
+	double bestScore = *gbest;
+	neighborhood.forEach([&](Particle const* const neighbor){ // Check neighbors fitness
+		double const currentScore = neighbor->getPbest();
 		if (currentScore < bestScore){
 			bestScore = currentScore;
-			bestNeighbor = i;
+			bestNeighbor = neighbor;
 		}
-	}
+	});
+	return bestNeighbor;
+}
 
-	if (bestNeighbor != -1){ // Update gbest
-		gbest = bestScore;
-		g = neighborhood[bestNeighbor]->getG();
-	}
+void Particle::updateGbest(){
+	Particle const* const bestNeighbor = findBestNeighbor();
+	if (bestNeighbor != NULL) // Take the neighbor's personal best, like NeighborhoodBest does, or its neighborhood best
+		copyBest(settings->legacyGbest ? bestNeighbor->best : bestNeighbor->p, bestNeighbor->getPbest());
 }
 
-void Particle::updatePbest(){
-	if (fitness < pbest){
-		pbest = fitness;
-		p = x;
-	}
+void Particle::followBest(double const* const position, double const value){
+	*gbest = value;
+	best = position;
+}
+
+void Particle::copyBest(double const* const position, double const value){
+	*gbest = value;
+	std::copy(position, position + D, g);
+	best = g;
 }
 
-bool Particle::isNeighbor(Particle* particle) const {
-	return std::find(neighborhood.begin(), neighborhood.end(), particle) != neighborhood.end();
+void Particle::updatePbest(){
+	if (*fitness < *pbest){
+		*pbest = *fitness;
+		std::copy(x, x + D, p);
+	}
 }
 
 int Particle::getNumberOfNeighbors() const{
 	return neighborhood.size();
 }
 
-void Particle::setXandUpdateV(std::vector<double> x, double fitness){
-	subtract(x, this->x, v); // Reverse engineer velocity
-	this->x = x;
-	this->fitness = fitness;
+void Particle::setXandUpdateV(ConstSpan const x, double fitness){
+	subtract(x.data(), this->x, v, D); // Reverse engineer velocity
+	std::copy(x.begin(), x.end(), this->x);
+	*this->fitness = fitness;
 }
@@ -2,6 +2,7 @@
 #include <IOHprofiler_csv_logger.h>
 #include "particleswarm.h"
 #include "particle.h"
+#include "population.h"
 #include "topologymanager.h"
 #include "particleupdatesettings.h"
 #include "repairhandler.h"
@@ -9,8 +10,33 @@
 #include <iostream>
 #include <fstream>
 #include "logger.h"
+#include "threadpool.h"
+#include "batchproblem.h"
+#include "neighborhoodbest.h"
+#include "checkpoint.h"
+#include "trajectorywriter.h"
 
-ParticleSwarm::ParticleSwarm(PSOConfig const config) : config(config){
+ParticleSwarm::ParticleSwarm(PSOConfig const config) : config(config), threads(0), logSuffix(""), trajectoryDecimation(1), legacyGbest(false){
+}
+
+void ParticleSwarm::setThreads(int const threads){
+	this->threads = threads;
+}
+
+void ParticleSwarm::setLogSuffix(std::string const logSuffix){
+	this->logSuffix = logSuffix;
+}
+
+void ParticleSwarm::setTrajectoryDecimation(int const trajectoryDecimation){
+	this->trajectoryDecimation = trajectoryDecimation;
+}
+
+void ParticleSwarm::setLegacyGbest(bool const legacyGbest){
+	this->legacyGbest = legacyGbest;
+}
+
+void ParticleSwarm::setCheckpoint(std::string const path, int const interval){
+	checkpointSettings = CheckpointSettings(path, interval);
 }
 
 void ParticleSwarm::reset(){}
@@ -36,38 +62,56 @@ void ParticleSwarm::runAsynchronous(std::shared_ptr<IOHprofiler_problem<double>
 	std::vector<double> const upperBound = problem->IOHprofiler_get_upperbound();
 
 	PSOConstraintHandler* const psoCH = psoCHs.at(config.constraintHandler)(lowerBound, upperBound); 
-	ParticleUpdateSettings const settings(config.update, particleUpdateParams, psoCH);
+	ParticleUpdateSettings const settings(config.update, particleUpdateParams, psoCH, legacyGbest);
 
-	std::vector<Particle*> particles(popSize);
-	for (int i = 0; i < popSize; i++){
-		particles[i] = new Particle(D, &settings);
-		particles[i]->randomize(lowerBound, upperBound);
-	}
+	Population population(popSize, D, &settings);
+	std::vector<Particle*> const& particles = population.getParticles();
+	population.randomize(lowerBound, upperBound);
 
 	TopologyManager* const topologyManager = topologies.at(config.topology)(particles);
 
-	Logger loggerAnimation("scratch/animations/" + getIdString() + "_f" +
-			std::to_string(problem->IOHprofiler_get_problem_id()) + "D" + std::to_string(D) + 
-			".log");
+	ResampleLogger loggerResamples("scratch/extra_data/" + getIdString() + logSuffix + ".rsp", problem->IOHprofiler_get_problem_id(), D);
 
-	while (	problem->IOHprofiler_get_evaluations() < evalBudget &&
+	RunCheckpoint checkpoint(checkpointSettings, getIdString(), problem, popSize, evalBudget);
+	int iteration = 0;
+	if (checkpoint.exists())
+		iteration = checkpoint.load([&](CheckpointReader& reader){
+			population.load(reader);
+			topologyManager->load(reader);
+			psoCH->load(reader);
+		});
+
+	TrajectoryWriter* const trajectory = trajectoryDecimation > 0 ? new TrajectoryWriter("scratch/animations/" +
+			getIdString() + logSuffix + "_f" + std::to_string(problem->IOHprofiler_get_problem_id()) + "D" +
+			std::to_string(D) + ".trj", popSize, D, trajectoryDecimation, iteration) : NULL;
+
+	while (	checkpoint.evaluations() < evalBudget &&
 			!problem->IOHprofiler_hit_optimal()){
 
+		if (checkpoint.due(iteration))
+			checkpoint.save(iteration, [&](CheckpointWriter& writer){
+				population.save(writer);
+				topologyManager->save(writer);
+				psoCH->save(writer);
+			});
+
 		for (Particle* p : particles){
 			p->evaluate(problem,logger);
 			p->updatePbest();
 			p->updateGbest();
-			p->updateVelocityAndPosition(double(problem->IOHprofiler_get_evaluations())/evalBudget);			
+			p->updateVelocityAndPosition(double(checkpoint.evaluations())/evalBudget);			
 		}
 
-		topologyManager->update(double(problem->IOHprofiler_get_evaluations())/evalBudget);	
-		loggerAnimation.log(particles);
+		topologyManager->update(double(checkpoint.evaluations())/evalBudget);	
+		if (trajectory)
+			trajectory->record(population);
+		loggerResamples.log(psoCH->takeResampleHistogram());
+		iteration++;
 	}
 
+	checkpoint.finish();
+	delete trajectory;
 	delete topologyManager;
-	for (Particle* particle : particles)
-		delete particle;
-	particles.clear();
 	delete psoCH;
 }
 
@@ -80,38 +124,70 @@ void ParticleSwarm::runSynchronous(std::shared_ptr<IOHprofiler_problem<double> >
 	std::vector<double> const upperBound = problem->IOHprofiler_get_upperbound(); 
 
 	PSOConstraintHandler* const psoCH = psoCHs.at(config.constraintHandler)(lowerBound, upperBound); 
-	ParticleUpdateSettings const settings(config.update, particleUpdateParams, psoCH);
+	ParticleUpdateSettings const settings(config.update, particleUpdateParams, psoCH, legacyGbest);
 
-	std::vector<Particle*> particles(popSize);
-	for (int i = 0; i < popSize; i++){
-		particles[i] = new Particle(D, &settings);
-		particles[i]->randomize(lowerBound, upperBound);
-	}
+	Population population(popSize, D, &settings);
+	std::vector<Particle*> const& particles = population.getParticles();
+	population.randomize(lowerBound, upperBound);
 
 	TopologyManager* const topologyManager = topologies.at(config.topology)(particles);
-
-	while (	problem->IOHprofiler_get_evaluations() < evalBudget &&
+	ThreadPool* const pool = threads > 0 ? new ThreadPool(threads) : NULL;
+	NeighborhoodBest neighborhoodBest(population, *topologyManager);
+	ResampleLogger loggerResamples("scratch/extra_data/" + getIdString() + logSuffix + ".rsp", problem->IOHprofiler_get_problem_id(), D);
+
+	RunCheckpoint checkpoint(checkpointSettings, getIdString(), problem, popSize, evalBudget);
+	int iteration = 0;
+	if (checkpoint.exists())
+		iteration = checkpoint.load([&](CheckpointReader& reader){
+			population.load(reader);
+			topologyManager->load(reader);
+			neighborhoodBest.load(reader);
+			psoCH->load(reader);
+		});
+
+	while (	checkpoint.evaluations() < evalBudget &&
 			!problem->IOHprofiler_hit_optimal()){
-		
-		for (Particle* p : particles){
-			p->evaluate(problem,logger);
-			p->updatePbest();
-		}
 
-		for (Particle* p : particles){
-			p->updateGbest();
-			p->updateVelocityAndPosition(double(problem->IOHprofiler_get_evaluations())/evalBudget);
+		if (checkpoint.due(iteration))
+			checkpoint.save(iteration, [&](CheckpointWriter& writer){
+				population.save(writer);
+				topologyManager->save(writer);
+				neighborhoodBest.save(writer);
+				psoCH->save(writer);
+			});
+
+		if (pool){
+			// Every parallelFor ends with a barrier, so each phase sees the complete previous phase
+			evaluateBatch(population.getSolutions(), problem, logger, *pool);
+			pool->parallelFor(popSize, [&](int const i){particles[i]->updatePbest();});
+			neighborhoodBest.update(pool);
+
+			double const progress = double(checkpoint.evaluations())/evalBudget;
+			pool->parallelForStreams(popSize, [&](int const i){particles[i]->updateVelocityAndPosition(progress);});
+		} else {
+			for (Particle* p : particles){
+				p->evaluate(problem,logger);
+				p->updatePbest();
+			}
+
+			if (!legacyGbest)
+				neighborhoodBest.update();
+			for (Particle* p : particles){
+				if (legacyGbest) // Later particles see the neighborhood bests of those that already moved
+					p->updateGbest();
+				p->updateVelocityAndPosition(double(checkpoint.evaluations())/evalBudget);
+			}
 		}
 
-	
-		topologyManager->update(double(problem->IOHprofiler_get_evaluations())/evalBudget);	
+		topologyManager->update(double(checkpoint.evaluations())/evalBudget);	
+		loggerResamples.log(psoCH->takeResampleHistogram());
+		iteration++;
 	}
 
+	checkpoint.finish();
 	delete topologyManager;
-	for (Particle* particle : particles)
-		delete particle;
-	particles.clear();
 	delete psoCH;
+	delete pool;
 }
 
 std::string ParticleSwarm::getIdString() const {
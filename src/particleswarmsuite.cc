@@ -2,53 +2,54 @@
 #include <iostream>
 #include <algorithm>
 
-ParticleSwarmSuite::ParticleSwarmSuite(){
+ParticleSwarmSuite::ParticleSwarmSuite() : space(4){
+	std::vector<std::string> updateManagers, topologyManagers, constraintHandlers;
 	for (auto& i : ::updateManagers)
-		this->updateManagers.push_back(i.first);
+		updateManagers.push_back(i.first);
 	for (auto& i : ::topologies)
-		this->topologyManagers.push_back(i.first);
+		topologyManagers.push_back(i.first);
 	for (auto& i : ::psoCHs)
-		this->constraintHandlers.push_back(i.first);
+		if (!optInCHs.count(i.first))
+			constraintHandlers.push_back(i.first);
 
-	this->synchronicities.push_back("A");
-	this->synchronicities.push_back("S");
-
-	generateConfigurations();
+	setUpdateManagers(updateManagers);
+	setTopologyManagers(topologyManagers);
+	setConstraintHandlers(constraintHandlers);
+	setSynchronicities({"A", "S"});
 }
 
-void ParticleSwarmSuite::generateConfigurations(){
-	configurations.clear();
-	for (auto update : updateManagers)
-		for (auto topology : topologyManagers)
-			for (auto ch : constraintHandlers)
-				for (auto synchronicity : synchronicities)
-					configurations.push_back(PSOConfig(update, topology, ch, synchronicity));
+ParticleSwarm ParticleSwarmSuite::create(std::vector<std::string> const& names) const {
+	return ParticleSwarm(PSOConfig(names[0], names[1], names[2], names[3]));
 }
 
 ParticleSwarm ParticleSwarmSuite::getParticleSwarm(int const i) {
-	return ParticleSwarm(configurations[i]);
+	return create(space.get(i));
+}
+
+ParticleSwarm ParticleSwarmSuite::getRandomParticleSwarm() {
+	return create(space.sample());
 }
 
 void ParticleSwarmSuite::setUpdateManagers(std::vector<std::string> updateManagers){
-	this->updateManagers = updateManagers;
-	generateConfigurations();
+	space.setComponent(0, updateManagers);
 }
 
 void ParticleSwarmSuite::setTopologyManagers(std::vector<std::string> topologyManagers){
-	this->topologyManagers = topologyManagers;
-	generateConfigurations();
+	space.setComponent(1, topologyManagers);
 }
 
 void ParticleSwarmSuite::setConstraintHandlers(std::vector<std::string> chs){
-	this->constraintHandlers = chs;
-	generateConfigurations();
+	space.setComponent(2, chs);
 }
 
 void ParticleSwarmSuite::setSynchronicities(std::vector<std::string> synchronicities){
-	this->synchronicities = synchronicities;
-	generateConfigurations();
+	space.setComponent(3, synchronicities);
+}
+
+void ParticleSwarmSuite::addFilter(ConfigurationSpace::Filter const filter){
+	space.addFilter(filter);
 }
 
 int ParticleSwarmSuite::size() const {
-	return configurations.size();
+	return space.size();
 }
@@ -8,33 +8,46 @@
 #include "particleupdatesettings.h"
 #include "util.h"
 #include "rng.h"
+#include "simd.h"
 
 /*		Base 		*/
-ParticleUpdateManager::ParticleUpdateManager(std::vector<double>& x, std::vector<double>& v,
-	std::vector<double>const& p, std::vector<double>const& g)
-	:x(x), v(v), p(p), g(g), D(x.size()){
+ParticleUpdateManager::ParticleUpdateManager(double* const x, double* const v,
+	double const* const p, double const* const& g, int const D)
+	:x(x), v(v), p(p), g(g), D(D), kernels(getVectorKernels(D)), r1(D), r2(D){
 }
 
 ParticleUpdateManager::~ParticleUpdateManager(){}
 
-void ParticleUpdateManager::updatePosition(){
-		std::transform (x.begin(), x.end(),
-				v.begin(), x.begin(),
-		std::plus<double>());
+void ParticleUpdateManager::updatePosition(Lanes const lanes){
+	lanes.forEach(D, [this](int const j){x[j] += v[j];});
 }
 
-void ParticleUpdateManager::updateVelocity(double const progress){
-		std::transform (x.begin(), x.end(),
-				v.begin(), x.begin(),
-		std::plus<double>());
+void ParticleUpdateManager::updateVelocity(double const progress, Lanes const lanes){
+	lanes.forEach(D, [this](int const j){x[j] += v[j];});
 }
 
-#define LC(X) [](std::vector<double>& x, std::vector<double>& v,\
-			std::vector<double>const& p, std::vector<double>const& g, \
-			std::map<int, double> parameters, std::vector<Particle*>& neighborhood){return new X(x,v,p,g, parameters, neighborhood);}
+void ParticleUpdateManager::inertiaVelocity(double const phi1, double const phi2, double const w, double const c, Lanes const lanes){
+	int const n = lanes.size(D);
+	rng.fillUniform(r1.data(), n, 0, phi1);
+	rng.fillUniform(r2.data(), n, 0, phi2);
+	if (lanes.all()){
+		kernels->updateVelocity(v, x, p, g, r1.data(), r2.data(), w, c, D);
+		return;
+	}
+
+	int k = 0; // The coefficients of the k-th coordinate, computed like the scalar kernel does
+	lanes.forEach(D, [&](int const j){
+		v[j] = ((v[j] * w + (p[j] - x[j]) * r1[k]) + (g[j] - x[j]) * r2[k]) * c;
+		k++;
+	});
+}
 
-std::map<std::string, std::function<ParticleUpdateManager* (std::vector<double>&, std::vector<double>&,
-		std::vector<double>const&, std::vector<double>const&, std::map<int,double>, std::vector<Particle*>&)>> const updateManagers({
+#define LC(X) [](double* const x, double* const v,\
+			double const* const p, double const* const& g, int const D, \
+			std::map<int, double> parameters, Neighborhood const& neighborhood){return new X(x,v,p,g,D, parameters, neighborhood);}
+
+std::map<std::string, std::function<ParticleUpdateManager* (double* const, double* const,
+		double const* const, double const* const&, int const, std::map<int,double>, Neighborhood const&)>> const updateManagers({
 		{"I", LC(InertiaWeightManager)},
 		{"D", LC(DecrInertiaWeightManager)},
 		{"C", LC(ConstrictionCoefficientManager)},
@@ -43,105 +56,82 @@ std::map<std::string, std::function<ParticleUpdateManager* (std::vector<double>&
 });
 
 /*		Inertia weight 		*/
-InertiaWeightManager::InertiaWeightManager (std::vector<double>& x, std::vector<double>& v,
-	std::vector<double>const& p, std::vector<double>const& g,  std::map<int, double> parameters, std::vector<Particle*>& neighborhood)
-	: ParticleUpdateManager(x,v,p,g),
+InertiaWeightManager::InertiaWeightManager (double* const x, double* const v,
+	double const* const p, double const* const& g, int const D,  std::map<int, double> parameters, Neighborhood const& neighborhood)
+	: ParticleUpdateManager(x,v,p,g,D),
 	phi1 (parameters.find(Setting::S_INER_PHI1) != parameters.end() ? parameters[Setting::S_INER_PHI1] : INER_PHI1_DEFAULT),
 	phi2 (parameters.find(Setting::S_INER_PHI2) != parameters.end() ? parameters[Setting::S_INER_PHI2] : INER_PHI2_DEFAULT),	
 	w (parameters.find(Setting::S_INER_W) != parameters.end() ? parameters[Setting::S_INER_W] : INER_W_DEFAULT){}
 
-void InertiaWeightManager::updateVelocity(double const progress) {
-	std::vector<double> pMinx(D);
-	subtract(p,x,pMinx);
-	std::vector<double> gMinx(D);	
-	subtract(g,x,gMinx);
-	randomMult(pMinx, 0, phi1);
-	randomMult(gMinx, 0, phi2);	
-	scale(v, w);
-	add(v,pMinx, v);
-	add(v,gMinx, v);
+void InertiaWeightManager::updateVelocity(double const progress, Lanes const lanes) {
+	inertiaVelocity(phi1, phi2, w, 1., lanes);
 }
 
 /*	Decreasing inertia weight manager */
-DecrInertiaWeightManager::DecrInertiaWeightManager (std::vector<double>& x, std::vector<double>& v,
-	std::vector<double>const& p, std::vector<double>const& g,  std::map<int, double> parameters, std::vector<Particle*>& neighborhood)
-	: ParticleUpdateManager(x,v,p,g),
+DecrInertiaWeightManager::DecrInertiaWeightManager (double* const x, double* const v,
+	double const* const p, double const* const& g, int const D,  std::map<int, double> parameters, Neighborhood const& neighborhood)
+	: ParticleUpdateManager(x,v,p,g,D),
 	phi1 (parameters.find(Setting::S_DINER_PHI1) != parameters.end() ? parameters[Setting::S_DINER_PHI1] : DINER_PHI2_DEFAULT),
 	phi2 (parameters.find(Setting::S_DINER_PHI2) != parameters.end() ? parameters[Setting::S_DINER_PHI2] : DINER_PHI2_DEFAULT),	
 	wMin (parameters.find(Setting::S_DINER_W_END) != parameters.end() ? parameters[Setting::S_DINER_W_END] : DINER_W_END_DEFAULT),
 	wMax(parameters.find(Setting::S_DINER_W_START) != parameters.end() ? parameters[Setting::S_DINER_W_START] : DINER_W_START_DEFAULT){}
 
-void DecrInertiaWeightManager::updateVelocity(double const progress) {
-	std::vector<double> pMinx(D);
-	subtract(p,x,pMinx);
-	std::vector<double> gMinx(D);
-	subtract(g,x,gMinx);
-	randomMult(pMinx, 0, phi1);
-	randomMult(gMinx, 0, phi2);
-	scale(v,wMax - progress * (wMax - wMin));
-	add(v,pMinx, v);
-	add(v,gMinx,v);
+void DecrInertiaWeightManager::updateVelocity(double const progress, Lanes const lanes) {
+	inertiaVelocity(phi1, phi2, wMax - progress * (wMax - wMin), 1., lanes);
 }
 
 /*		Constriction Coefficient 		*/
-ConstrictionCoefficientManager::ConstrictionCoefficientManager(std::vector<double> & x, std::vector<double> & v,
-	std::vector<double>const& p, std::vector<double>const& g,  std::map<int, double> parameters, std::vector<Particle*>& neighborhood)
-	: ParticleUpdateManager(x,v,p,g),
+ConstrictionCoefficientManager::ConstrictionCoefficientManager(double* const x, double* const v,
+	double const* const p, double const* const& g, int const D,  std::map<int, double> parameters, Neighborhood const& neighborhood)
+	: ParticleUpdateManager(x,v,p,g,D),
 	phi1 (parameters.find(Setting::S_CC_PHI1) != parameters.end() ? parameters[Setting::S_CC_PHI1] : CC_PHI1_DEFAULT),
 	phi2 (parameters.find(Setting::S_CC_PHI2) != parameters.end() ? parameters[Setting::S_CC_PHI2] : CC_PHI2_DEFAULT),
 	chi (2.0 / ((phi1+phi2) - 2 + sqrt(pow(phi1+phi2, 2.0) - 4 * (phi1+phi2)))){}
 
-void ConstrictionCoefficientManager::updateVelocity(double const progress){
-	std::vector<double> pMinx(D);
-	subtract(p,x,pMinx);
-	std::vector<double> gMinx(D);
-	subtract(g,x,gMinx);
-	randomMult(pMinx, 0, phi1);
-	randomMult(gMinx, 0, phi2);
-	add(v,pMinx,v);
-	add(v,gMinx,v);
-	scale(v, chi);
+void ConstrictionCoefficientManager::updateVelocity(double const progress, Lanes const lanes){
+	inertiaVelocity(phi1, phi2, 1., chi, lanes);
 }
 
 /*		Fully Informed 		*/
-FIPSManager::FIPSManager(std::vector<double> & x, std::vector<double> & v,
-	std::vector<double>const& p, std::vector<double>const& g,  std::map<int, double> parameters
-	, std::vector<Particle*>& neighborhood)
-	: ParticleUpdateManager(x,v,p,g),
+FIPSManager::FIPSManager(double* const x, double* const v,
+	double const* const p, double const* const& g, int const D,  std::map<int, double> parameters
+	, Neighborhood const& neighborhood)
+	: ParticleUpdateManager(x,v,p,g,D),
 	phi (parameters.find(Setting::S_FIPS_PHI) != parameters.end() ? parameters[Setting::S_FIPS_PHI] : FIPS_PHI_DEFAULT),
 	chi (2.0 / ((phi) -2 + sqrt( pow(phi, 2.0) - 4 * (phi)))),
 	neighborhood(neighborhood){}
 
 
-void FIPSManager::updateVelocity(double const progress){
-	std::vector<double> sum(D,0.0);
-	std::vector<double> pMinx(D);
-
-	std::vector< std::vector<double> > p_n;
-	p_n.reserve(neighborhood.size());
-	for (Particle* n : neighborhood)
-		p_n.push_back(n->getP());
+void FIPSManager::updateVelocity(double const progress, Lanes const lanes){
+	neighborP.clear();
+	neighborhood.forEach([this](Particle const* const neighbor){neighborP.push_back(neighbor->getPView().data());});
+	int const neighbors = neighborP.size();
+	weights.resize(neighbors);
 
-	for (int i = 0; i < (int) neighborhood.size(); i++){
-		subtract(p_n[i], x, pMinx);
-		scale(pMinx, rng.randDouble(0,phi));
-		add(sum, pMinx, sum);		
+	rng.fillUniform(weights.data(), neighbors, 0, phi);
+	if (lanes.all()){
+		kernels->fullyInformedVelocity(v, x, neighborP.data(), weights.data(), neighbors, chi, D);
+		return;
 	}
 
-	scale(sum, 1.0/neighborhood.size());
-	add(v,sum,v);
-	scale(v, chi);
+	double const inverse = 1.0 / neighbors; // As the scalar kernel computes it
+	lanes.forEach(D, [&](int const j){
+		double sum = 0.;
+		for (int k = 0; k < neighbors; k++)
+			sum = sum + (neighborP[k][j] - x[j]) * weights[k];
+		v[j] = (v[j] + sum * inverse) * chi;
+	});
 }
 
 /* 		Bare Bones 		*/
-BareBonesManager::BareBonesManager(std::vector<double> & x, std::vector<double> & v,
-	std::vector<double>const& p, std::vector<double>const& g,  std::map<int, double> parameters, std::vector<Particle*>& neighborhood) :
-	ParticleUpdateManager(x,v,p,g) {}
+BareBonesManager::BareBonesManager(double* const x, double* const v,
+	double const* const p, double const* const& g, int const D,  std::map<int, double> parameters, Neighborhood const& neighborhood) :
+	ParticleUpdateManager(x,v,p,g,D) {}
 
-void BareBonesManager::updatePosition(){
-	for (int i = 0; i < D; i++){
+void BareBonesManager::updatePosition(Lanes const lanes){
+	lanes.forEach(D, [this](int const i){
 		x[i] = rng.normalDistribution((g[i] + p[i]) / 2.0, std::abs(g[i] - p[i]));
-	}
+	});
 }
 
-void BareBonesManager::updateVelocity(double const progress){ /* Do nothing*/ }
+void BareBonesManager::updateVelocity(double const progress, Lanes const lanes){ /* Do nothing*/ }
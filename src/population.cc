@@ -0,0 +1,149 @@
+#include "population.h"
+#include "particleupdatesettings.h"
+#include "rng.h"
+#include "checkpoint.h"
+#include <limits>
+
+Population::Population(int const size, int const D)
+	: X(size * D), fitness(size, std::numeric_limits<double>::max()), size(size), D(D){
+	solutionViews.reserve(size); // Views must never be relocated
+	for (int i = 0; i < size; i++)
+		solutionViews.emplace_back(*this, i);
+
+	solutions.reserve(size);
+	for (Solution& s : solutionViews)
+		solutions.push_back(&s);
+}
+
+Population::Population(int const size, int const D, ParticleUpdateSettings const*const settings)
+	: X(size * D), V(size * D), P(size * D), G(size * D), fitness(size, std::numeric_limits<double>::max()),
+	pbest(size, std::numeric_limits<double>::max()), gbest(size, std::numeric_limits<double>::max()),
+	size(size), D(D){
+	particleViews.reserve(size); // Views must never be relocated
+	for (int i = 0; i < size; i++)
+		particleViews.emplace_back(*this, i, settings);
+
+	particles.reserve(size);
+	solutions.reserve(size);
+	for (Particle& p : particleViews){
+		particles.push_back(&p);
+		solutions.push_back(&p);
+	}
+}
+
+double* Population::getX(int const i){
+	return &X[i * D];
+}
+
+double const* Population::getX(int const i) const {
+	return &X[i * D];
+}
+
+double* Population::getV(int const i){
+	return &V[i * D];
+}
+
+double const* Population::getV(int const i) const {
+	return &V[i * D];
+}
+
+double* Population::getP(int const i){
+	return &P[i * D];
+}
+
+double const* Population::getP(int const i) const {
+	return &P[i * D];
+}
+
+double* Population::getG(int const i){
+	return &G[i * D];
+}
+
+double const* Population::getG(int const i) const {
+	return &G[i * D];
+}
+
+double Population::getFitness(int const i) const {
+	return fitness[i];
+}
+
+double Population::getPbest(int const i) const {
+	return pbest[i];
+}
+
+Solution* Population::getSolution(int const i) const {
+	return solutions[i];
+}
+
+Particle* Population::getParticle(int const i) const {
+	return particles[i];
+}
+
+std::vector<Solution*> const& Population::getSolutions() const {
+	return solutions;
+}
+
+std::vector<Particle*> const& Population::getParticles() const {
+	return particles;
+}
+
+void Population::randomize(std::vector<double> const& lowerBounds, std::vector<double> const& upperBounds){
+	for (Solution* s : solutions)
+		s->randomize(lowerBounds, upperBounds);
+}
+
+int Population::getBestIndex() const {
+	int best = 0;
+	for (int i = 1; i < size; i++)
+		if (fitness[i] < fitness[best])
+			best = i;
+	return best;
+}
+
+void Population::save(CheckpointWriter& writer) const {
+	writer.write<int64_t>(size);
+	writer.write<int64_t>(D);
+	writer.write(X);
+	writer.write(V);
+	writer.write(P);
+	writer.write(G);
+	writer.write(fitness);
+	writer.write(pbest);
+	writer.write(gbest);
+
+	std::vector<uint8_t> evaluated(size);
+	for (int i = 0; i < size; i++)
+		evaluated[i] = solutions[i]->isEvaluated();
+	writer.write(evaluated);
+
+	std::vector<int32_t> followed(particles.size()); // Row of P a particle follows, -1 for its own g
+	for (unsigned int i = 0; i < particles.size(); i++)
+		followed[i] = particles[i]->best == particles[i]->g ? -1 : (particles[i]->best - P.data()) / D;
+	writer.write(followed);
+}
+
+void Population::load(CheckpointReader& reader){
+	reader.expect(size, "population size");
+	reader.expect(D, "dimension");
+	reader.readInPlace(X);
+	reader.readInPlace(V);
+	reader.readInPlace(P);
+	reader.readInPlace(G);
+	reader.readInPlace(fitness);
+	reader.readInPlace(pbest);
+	reader.readInPlace(gbest);
+
+	std::vector<uint8_t> evaluated;
+	reader.read(evaluated);
+	for (int i = 0; i < size; i++){
+		if (evaluated[i])
+			solutions[i]->setFitness(fitness[i]);
+		else
+			solutions[i]->modifyX();
+	}
+
+	std::vector<int32_t> followed;
+	reader.read(followed);
+	for (unsigned int i = 0; i < particles.size(); i++)
+		particles[i]->best = followed[i] == -1 ? particles[i]->g : &P[followed[i] * D];
+}
@@ -5,21 +5,37 @@
 #include "hybridalgorithm.h"
 #include "repairhandler.h"
 #include "particle.h"
+#include "population.h"
+#include "generationarena.h"
 #include "topologymanager.h"
 #include "particleupdatesettings.h"
 #include "util.h"
 #include "mutationmanager.h"
 #include "psode2.h"
 #include "deadaptationmanager.h"
+#include "checkpoint.h"
+#include "logger.h"
 #include <limits>
 #include <iostream>
 #include <algorithm> 
 
 PSODE2::PSODE2(HybridConfig const config)
-		: HybridAlgorithm(config){}
+		: HybridAlgorithm(config), useArena(true), legacyGbest(false){}
 
 PSODE2::~PSODE2(){}
 
+void PSODE2::setArena(bool const useArena){
+	this->useArena = useArena;
+}
+
+void PSODE2::setLegacyGbest(bool const legacyGbest){
+	this->legacyGbest = legacyGbest;
+}
+
+void PSODE2::setCheckpoint(std::string const path, int const interval){
+	checkpointSettings = CheckpointSettings(path, interval);
+}
+
 void PSODE2::run(std::shared_ptr<IOHprofiler_problem<double> > problem, 
 			std::shared_ptr<IOHprofiler_csv_logger> logger,
 			int const evalBudget, int const popSize, std::map<int,double> particleUpdateParams){
@@ -37,31 +53,65 @@ void PSODE2::runAsynchronous(std::shared_ptr<IOHprofiler_problem<double> > probl
 
 	DEConstraintHandler *const deCH = deCHs.at(config.deCH)(lowerBound,upperBound);
 	PSOConstraintHandler *const psoCH = psoCHs.at(config.psoCH)(lowerBound,upperBound);
-	ParticleUpdateSettings const settings(config.update, particleUpdateParams, psoCH);
+	ParticleUpdateSettings const settings(config.update, particleUpdateParams, psoCH, legacyGbest);
 
 	int const split = popSize / 2;
-	for (int i = 0; i < split; i++) psoPop.push_back(new Particle(D, &settings));
-	for (int i = split; i < popSize; i++) dePop.push_back(new Solution(D));
+	Population psoPopulation(split, D, &settings);
+	Population dePopulation(popSize - split, D);
+	psoPop = psoPopulation.getParticles();
+	dePop = dePopulation.getSolutions();
 	particles.insert(particles.end(), psoPop.begin(), psoPop.end());
 	particles.insert(particles.end(), dePop.begin(), dePop.end());
 
-	for (Solution* const p : particles){
-		p->randomize(lowerBound, upperBound);
-		p->evaluate(problem, logger);
-	}
+	RunCheckpoint checkpoint(checkpointSettings, getIdString(), problem, popSize, evalBudget);
+	bool const resume = checkpoint.exists();
+
+	if (!resume) // Otherwise the populations are loaded below
+		for (Solution* const p : particles){
+			p->randomize(lowerBound, upperBound);
+			p->evaluate(problem, logger);
+		}
 
 	TopologyManager* const topologyManager = topologies.at(config.topology)(psoPop);
 	MutationManager* const mutationManager = mutations.at(config.mutation)(D, deCH);
 	CrossoverManager const*const crossoverManager = crossovers.at(config.crossover)(D);
-	DEAdaptationManager *const adaptationManager = deAdaptations.at(config.adaptation)(popSize);
+	DEAdaptationManager *const adaptationManager = deAdaptations.at(config.adaptation)(dePop.size());
 
 	std::vector<double> Fs(dePop.size());
 	std::vector<double> Crs(dePop.size());
 
+	GenerationArena* const arena = useArena ? new GenerationArena(dePop.size(), D) : NULL;
+
+	// Both constraint handlers count resamples, so each half of the population has its own histogram
+	ResampleLogger psoResamples("scratch/extra_data/" + getIdString() + "_pso.rsp", problem->IOHprofiler_get_problem_id(), D);
+	ResampleLogger deResamples("scratch/extra_data/" + getIdString() + "_de.rsp", problem->IOHprofiler_get_problem_id(), D);
+
 	int iterations = 0;
-	while (problem->IOHprofiler_get_evaluations() < evalBudget &&
+	if (resume)
+		iterations = checkpoint.load([&](CheckpointReader& reader){
+			psoPopulation.load(reader);
+			dePopulation.load(reader);
+			topologyManager->load(reader);
+			mutationManager->load(reader);
+			adaptationManager->load(reader);
+			deCH->load(reader);
+			psoCH->load(reader);
+		});
+
+	while (checkpoint.evaluations() < evalBudget &&
 			!problem->IOHprofiler_hit_optimal()){
 
+		if (checkpoint.due(iterations))
+			checkpoint.save(iterations, [&](CheckpointWriter& writer){
+				psoPopulation.save(writer);
+				dePopulation.save(writer);
+				topologyManager->save(writer);
+				mutationManager->save(writer);
+				adaptationManager->save(writer);
+				deCH->save(writer);
+				psoCH->save(writer);
+			});
+
 		// Get new DE parameters from the adaptation manager (JADE or constant)
 		adaptationManager->nextF(Fs);
 		adaptationManager->nextCr(Crs);
@@ -72,52 +122,60 @@ void PSODE2::runAsynchronous(std::shared_ptr<IOHprofiler_problem<double> > probl
 		for (Particle* const p : psoPop){
 			p->updatePbest();
 			p->updateGbest();
-			p->updateVelocityAndPosition(double(problem->IOHprofiler_get_evaluations())/double(evalBudget));			
+			p->updateVelocityAndPosition(double(checkpoint.evaluations())/double(evalBudget));			
 			p->evaluate(problem,logger);
 		}
+		psoResamples.log(psoCH->takeResampleHistogram());
+
+		// Perform mutation and crossover
+		std::vector<Solution*> trials;
+		if (arena){
+			mutationManager->mutate(dePop, Fs, arena->getDonors());
+			crossoverManager->crossover(dePop, arena->getDonors(), Crs, arena->getTrials());
+			trials = arena->getTrials();
+		} else {
+			std::vector<Solution*> const donors = mutationManager->mutate(dePop, Fs);
+			trials = crossoverManager->crossover(dePop, donors, Crs);
+
+			for (Solution* d : donors) 
+				delete d;
+		}
+		deResamples.log(deCH->takeResampleHistogram());
 
-		// Perform mutation 
-		std::vector<Solution*> const donors = mutationManager->mutate(dePop, Fs);
-		// Perform crossover
-		std::vector<Solution*> const trials = crossoverManager->crossover(dePop, donors, Crs);
-
-		for (Solution* d : donors) 
-			delete d;
-
-		std::vector<double> parentF(popSize), trialF(popSize);
 		for (unsigned int i = 0; i < dePop.size(); i++){
 			//Evaluate the parent vector
-			parentF[i] = dePop[i]->evaluate(problem,logger);
+			double const parentF = dePop[i]->evaluate(problem,logger);
 
 			//Evaluate the trial vector
-			trialF[i] = trials[i]->evaluate(problem,logger);
+			double const trialF = trials[i]->evaluate(problem,logger);
+			adaptationManager->recordTrial(i, parentF, trialF);
 
 			// Perform selection
-			if ( trialF[i] < parentF[i] ){
-				dePop[i]->setX(trials[i]->getX(), trials[i]->getFitness());
+			if (adaptationManager->succeeded(i)){
+				dePop[i]->setX(trials[i]->getXView(), trials[i]->getFitness());
 			}
 		}
 
-		for (Solution* p : trials)
-			delete p;
+		if (!arena)
+			for (Solution* p : trials)
+				delete p;
 
 		if (iterations % 10 == 0)
 			share();
 
-		adaptationManager->update(parentF, trialF);
+		adaptationManager->update(Fs, Crs);
 		iterations++;	
-		topologyManager->update(double(problem->IOHprofiler_get_evaluations())/evalBudget);	
+		topologyManager->update(double(checkpoint.evaluations())/evalBudget);	
 	}
 
+	checkpoint.finish();
 	delete topologyManager;
 	delete mutationManager;
 	delete crossoverManager;
 	delete adaptationManager;
 	delete deCH;
 	delete psoCH;
-
-	for (Solution* particle : particles)
-		delete particle;
+	delete arena;
 
 	particles.clear();
 	dePop.clear();
@@ -133,9 +191,9 @@ void PSODE2::share(){
 	Solution* const best_de = getPBest(dePop);
 	Particle* const best_pso = getPBest(psoPop);
 
-	std::vector<double> const x = best_pso->getX();
+	std::vector<double> x = best_pso->getX();
 	double const y = best_pso->getFitness();
 
-	best_pso->setXandUpdateV(best_de->getX(), best_de->getFitness());
-	best_de->setX(x, y);
+	best_pso->setXandUpdateV(best_de->getXView(), best_de->getFitness());
+	best_de->setX(std::move(x), y);
 }
@@ -27,117 +27,82 @@ void HyperbolicRepair::repairVelocityPre(Particle * const p) {
 }
 
 void PBestDimRepair::repairPSO(Particle* const p) {
-	bool repaired = false;
-	for (int i = 0; i < D; i++){
-		if (p->getX(i) < lb[i] || p->getX(i) > ub[i]){
-			p->setX(i, p->getP(i));
-			repairVelocityPost(p, i);
-			repaired = true;
-		}
-	}	
-	if (repaired) nCorrected++;
+	double* const x = p->modifyX();
+	if (forEachViolation(x, lb.data(), ub.data(), [&](int const i){
+		x[i] = p->getP(i);
+		repairVelocityPost(p, i);
+	}))
+		nCorrected++;
 }
 
 // Differential Evolution
 void RandBaseRepair::repairDE(Solution* const p, Solution const* const base, Solution const* const target) {
-	bool repaired = false;
-	for (int i = 0; i < D; i++){
-		if (p->getX(i) > ub[i]){
-			p->setX(i, base->getX(i) + rng.randDouble(0,1) * (ub[i] - base->getX(i)));
-			repaired=true;
-		} else if (p->getX(i) < lb[i]){
-			p->setX(i, base->getX(i) + rng.randDouble(0,1) * (lb[i] - base->getX(i)));
-			repaired=true;
-		}
-	}
-	if (repaired) nCorrected++;
+	double* const x = p->modifyX();
+	double const* const b = base->getXView().data();
+	if (forEachViolation(x, lb.data(), ub.data(), [&](int const i){
+		double const bound = x[i] > ub[i] ? ub[i] : lb[i];
+		x[i] = b[i] + rng.randDouble(0,1) * (bound - b[i]);
+	}))
+		nCorrected++;
 }
 
 void MidpointBaseRepair::repairDE(Solution* const p, Solution const* const base, Solution const* const target) {
-	bool repaired = false;
-	for (int i = 0; i < D; i++){
-		if (p->getX(i) > ub[i]){
-			p->setX(i, 0.5 * (base->getX(i) + ub[i]));
-			repaired=true;
-		} else if (p->getX(i) < lb[i]){
-			p->setX(i, 0.5 * (base->getX(i) + lb[i]));
-			repaired=true;
-		}
-	}
-	if (repaired) nCorrected++;
+	double* const x = p->modifyX();
+	double const* const b = base->getXView().data();
+	if (forEachViolation(x, lb.data(), ub.data(), [&](int const i){
+		x[i] = 0.5 * (b[i] + (x[i] > ub[i] ? ub[i] : lb[i]));
+	}))
+		nCorrected++;
 }
 
 void MidpointTargetRepair::repairDE(Solution* const p, Solution const* const base, Solution const* const target) {
-	bool repaired = false;
-	for (int i = 0; i < D; i++){
-		if (p->getX(i) > ub[i]){
-			p->setX(i, 0.5 * (target->getX(i) + ub[i]));
-			repaired=true;
-		} else if (p->getX(i) < lb[i]){
-			p->setX(i, 0.5 * (target->getX(i) + lb[i]));
-			repaired=true;
-		}
-	}
-	if (repaired) nCorrected++;
+	double* const x = p->modifyX();
+	double const* const t = target->getXView().data();
+	if (forEachViolation(x, lb.data(), ub.data(), [&](int const i){
+		x[i] = 0.5 * (t[i] + (x[i] > ub[i] ? ub[i] : lb[i]));
+	}))
+		nCorrected++;
 }
 
 void ProjectionMidpointRepair::repairDE(Solution* const p, Solution const* const base, Solution const* const target) {
-	std::vector<double> x = p->getX();
-	std::vector<double>alphas(D+1);
-	alphas[D] = 1.;
-
-	for (int i = 0; i < D; i++){
-		if (x[i] > ub[i]){
-			alphas[i] = (lb[i] - ub[i])/(lb[i] - 2. * x[i] + ub[i]);
-		} else if (x[i] < lb[i]){
-			alphas[i] = (ub[i] - lb[i])/(lb[i] - 2. * x[i] + ub[i]);
-		} else
-			alphas[i] = std::numeric_limits<double>::max(); 
-	}
-
-	std::vector<double>::iterator alpha=std::min_element(alphas.begin(), alphas.end());
-	if (alpha != std::next(alphas.end(), -1)){
-		std::vector<double> midpoint(D);
-		add(lb, ub, midpoint);
-		scale(midpoint, 0.5*(1.- *alpha));
-		scale(x, *alpha);
-		add(x, midpoint, x);
-		p->setX(x);
+	double alpha = 1.; 
+	double* const x = p->modifyX();
+	bool const infeasible = forEachViolation(x, lb.data(), ub.data(), [&](int const i){
+		if (x[i] > ub[i])
+			alpha = std::min(alpha, (lb[i] - ub[i])/(lb[i] - 2. * x[i] + ub[i]));
+		else
+			alpha = std::min(alpha, (ub[i] - lb[i])/(lb[i] - 2. * x[i] + ub[i]));
+	});
+
+	if (infeasible){
+		for (int i = 0; i < D; i++)
+			x[i] = alpha * x[i] + 0.5 * (1. - alpha) * (lb[i] + ub[i]);
 		nCorrected++;
 	}
 }
 
 void ProjectionBaseRepair::repairDE(Solution* const p, Solution const* const base, Solution const* const target) {
-	std::vector<double> x = p->getX();
-	std::vector<double> alphas(D+1);
-	alphas[D] = 1.;
-
-	for (int i = 0; i < D; i++){
-		if (x[i] > ub[i] && x[i] - base->getX(i) > 1.0e-12){
-			alphas[i] = (ub[i] - base->getX(i)) / (x[i] - base->getX(i));
-		} else if (x[i] < lb[i] && base->getX(i) - x[i] > 1.0e-12){
-			alphas[i] = (base->getX(i) - lb[i]) / (base->getX(i) - x[i]);
-		} else
-			alphas[i] = std::numeric_limits<double>::max(); 
-	}
-
-	std::vector<double>::iterator alpha=std::min_element(alphas.begin(), alphas.end());
-	if (alpha != std::next(alphas.end(), -1)){
-		std::vector<double> b = base->getX();
-		scale(b, (1.-*alpha));
-		scale(x, *alpha);
-		add(x, b, x);
-		p->setX(x);
+	double alpha = std::numeric_limits<double>::max();
+	double* const x = p->modifyX();
+	double const* const b = base->getXView().data();
+
+	forEachViolation(x, lb.data(), ub.data(), [&](int const i){
+		if (x[i] > ub[i] && x[i] - b[i] > 1.0e-12)
+			alpha = std::min(alpha, (ub[i] - b[i]) / (x[i] - b[i]));
+		else if (x[i] < lb[i] && b[i] - x[i] > 1.0e-12)
+			alpha = std::min(alpha, (b[i] - lb[i]) / (b[i] - x[i]));
+	});
+
+	if (alpha <= 1.){
+		for (int i = 0; i < D; i++)
+			x[i] = alpha * x[i] + (1. - alpha) * b[i];
 		nCorrected++;
 	}
 
 	// Fix the solutions that were over the bound by less than 1e-12
-	for (int i = 0; i < D; i++){
-		if (p->getX(i) < lb[i])
-			p->setX(i, lb[i]);
-		else if (p->getX(i) > ub[i])
-			p->setX(i, ub[i]);
-	}
+	forEachViolation(x, lb.data(), ub.data(), [&](int const i){
+		x[i] = x[i] < lb[i] ? lb[i] : ub[i];
+	});
 }
 
 void ConservatismRepair::repairDE(Solution* const p, Solution const*const base, Solution const*const target){
@@ -148,16 +113,23 @@ void ConservatismRepair::repairDE(Solution* const p, Solution const*const base,
 }
 
 // Generic
+ResamplingRepair::ResamplingRepair(std::vector<double> const lb, std::vector<double> const ub, int const maxResamples)
+	:ConstraintHandler(lb,ub), DEConstraintHandler(lb,ub), PSOConstraintHandler(lb, ub), maxResamples(maxResamples),
+	histogram(new std::atomic<int>[maxResamples + 1]){
+	for (int i = 0; i <= maxResamples; i++)
+		histogram[i] = 0;
+}
+
 bool ResamplingRepair::resample(Solution * const p, int const resamples) {
 	if (isFeasible(p)){
+		histogram[resamples]++;
 		return false;
-	} else if (resamples >= 100){
-		for (int i = 0; i < D; i++){
-			if (p->getX(i) < lb[i])
-				p->setX(i, lb[i]);
-			else if (p->getX(i) > ub[i])
-				p->setX(i, ub[i]);
-		}
+	} else if (resamples >= maxResamples){
+		double* const x = p->modifyX();
+		forEachViolation(x, lb.data(), ub.data(), [&](int const i){
+			x[i] = x[i] < lb[i] ? lb[i] : ub[i];
+		});
+		histogram[resamples]++;
 		return false;
 	}
 
@@ -166,6 +138,36 @@ bool ResamplingRepair::resample(Solution * const p, int const resamples) {
 	return true;
 }
 
+int DimensionResamplingRepair::coordinatesToRedraw(double* const x, int const resamples, int const redrawn, int* const lanes){
+	int n = 0;
+	forEachViolation(x, lb.data(), ub.data(), [&](int const i){
+		lanes[n++] = i;
+	});
+
+	int const redraw = std::min(n, budget - redrawn); // The first coordinates if the budget does not cover all
+	if (redraw > 0){
+		if (resamples == 0) nCorrected++; // Only count the first resample
+		return redraw;
+	}
+
+	for (int k = 0; k < n; k++){ // Feasible, or out of budget
+		int const i = lanes[k];
+		x[i] = x[i] < lb[i] ? lb[i] : ub[i];
+	}
+	histogram[resamples]++;
+	return 0;
+}
+
+std::vector<int> ResamplingRepair::takeResampleHistogram(){
+	std::vector<int> counts;
+	for (int i = 0; i <= maxResamples; i++)
+		counts.push_back(histogram[i].exchange(0));
+
+	while (!counts.empty() && counts.back() == 0) // Drop the unused tail
+		counts.pop_back();
+	return counts;
+}
+
 void DeathPenalty::penalize(Solution* const p) {
 	if (!isFeasible(p)){
 		p->setFitness(std::numeric_limits<double>::max());
@@ -173,226 +175,176 @@ void DeathPenalty::penalize(Solution* const p) {
 	}
 }
 
+// The batch repairs count the repaired rows and update nCorrected once
+#define REPAIR_BATCH(X) void X::repairBatch(std::vector<Solution*> const& solutions){\
+	int repaired = 0;\
+	for (Solution* const s : solutions)\
+		repaired += repairRow(s->modifyX());\
+	nCorrected += repaired;\
+}
+
 // Reinitialization
-void ReinitializationRepair::repair(Particle* const p) {
-	bool repaired = false;
-	for (int i = 0; i < D; i++){
-		if (p->getX(i) < lb[i] || p->getX(i) > ub[i]){
-			p->setX(i, rng.randDouble(lb[i], ub[i]));
-			repairVelocityPost(p, i);
-			repaired = true;
-		}
-	}
+bool ReinitializationRepair::repairRow(double* const x) const {
+	return forEachViolation(x, lb.data(), ub.data(), [&](int const i){
+		x[i] = rng.randDouble(lb[i], ub[i]);
+	}) > 0;
+}
 
-	if (repaired) nCorrected++;
+void ReinitializationRepair::repair(Particle* const p) {
+	double* const x = p->modifyX();
+	if (forEachViolation(x, lb.data(), ub.data(), [&](int const i){
+		x[i] = rng.randDouble(lb[i], ub[i]);
+		repairVelocityPost(p, i);
+	}))
+		nCorrected++;
 }
 
 void ReinitializationRepair::repair(Solution* const p) {
-	bool repaired = false;
-	for (int i = 0; i < D; i++){
-		if (p->getX(i) < lb[i] || p->getX(i) > ub[i]){
-			p->setX(i, rng.randDouble(lb[i], ub[i]));
-			repaired=true;
-		}
-	}
-	if (repaired) nCorrected++;
+	if (repairRow(p->modifyX())) nCorrected++;
 }
 
+REPAIR_BATCH(ReinitializationRepair)
+
 // Projection
+bool ProjectionRepair::repairRow(double* const x) const {
+	return forEachViolation(x, lb.data(), ub.data(), [&](int const i){
+		x[i] = x[i] < lb[i] ? lb[i] : ub[i];
+	}) > 0;
+}
+
 void ProjectionRepair::repair(Particle* const p) {
-	bool repaired = false;
-	for (int i = 0; i < D; i++){
-		if (p->getX(i) < lb[i]){
-			p->setX(i, lb[i]);
-			repairVelocityPost(p, i);
-			repaired = true;
-		} else if (p->getX(i) > ub[i]){
-			p->setX(i, ub[i]);
-			repairVelocityPost(p, i);
-			repaired = true;
-		}
-	}
-	if (repaired) nCorrected++;
+	double* const x = p->modifyX();
+	if (forEachViolation(x, lb.data(), ub.data(), [&](int const i){
+		x[i] = x[i] < lb[i] ? lb[i] : ub[i];
+		repairVelocityPost(p, i);
+	}))
+		nCorrected++;
 }
+
 void ProjectionRepair::repair(Solution* const p) {
-	bool repaired = false;
-	for (int i = 0; i < D; i++){
-		if (p->getX(i) < lb[i]){
-			p->setX(i, lb[i]);
-			repaired=true;
-		} else if (p->getX(i) > ub[i]){
-			p->setX(i, ub[i]);
-			repaired=true;
-		}
-	}
-	if (repaired) nCorrected++;
+	if (repairRow(p->modifyX())) nCorrected++;
 }
 
+REPAIR_BATCH(ProjectionRepair)
+
 // Reflection
-void ReflectionRepair::repair(Particle* const p) {
-	bool repaired = false;
-	for (int i = 0; i < D; i++){
-		while (true){
-			if (p->getX(i) < lb[i]){
-				p->setX(i, 2. * lb[i] - p->getX(i));
-				repairVelocityPost(p,i);
-				repaired=true;
-			}
-			else if (p->getX(i) > ub[i]){
-				p->setX(i, 2. * ub[i] - p->getX(i));
-				repairVelocityPost(p,i);
-				repaired=true;
-			} else
-				break;
-		}
+namespace {
+	double reflect(double const x, double const lb, double const ub){
+		double const y = x < lb ? 2. * lb - x : 2. * ub - x; // One reflection is almost always enough
+		if (y >= lb && y <= ub)
+			return y;
+
+		double const width = ub - lb; // Otherwise fold over the period of repeated reflections
+		if (width <= 0.)
+			return lb;
+		double t = std::fmod(x - lb, 2. * width);
+		if (t < 0.)
+			t += 2. * width;
+		return t <= width ? lb + t : lb + (2. * width - t);
 	}
-	if (repaired) nCorrected++;
+}
+
+bool ReflectionRepair::repairRow(double* const x) const {
+	return forEachViolation(x, lb.data(), ub.data(), [&](int const i){
+		x[i] = reflect(x[i], lb[i], ub[i]);
+	}) > 0;
+}
+
+void ReflectionRepair::repair(Particle* const p) {
+	double* const x = p->modifyX();
+	if (forEachViolation(x, lb.data(), ub.data(), [&](int const i){
+		x[i] = reflect(x[i], lb[i], ub[i]);
+		repairVelocityPost(p,i);
+	}))
+		nCorrected++;
 }
 
 void ReflectionRepair::repair(Solution* const p) {
-	bool repaired = false;
-	for (int i = 0; i < D; i++){
-		while (true){
-			if (p->getX(i) < lb[i]){
-				p->setX(i, 2. * lb[i] - p->getX(i));
-				repaired=true;
-			}
-			else if (p->getX(i) > ub[i]){
-				p->setX(i, 2. * ub[i] - p->getX(i));
-				repaired=true;
-			} else
-				break;
-		}
-	}
-	if (repaired) nCorrected++;
+	if (repairRow(p->modifyX())) nCorrected++;
 }
 
+REPAIR_BATCH(ReflectionRepair)
+
 // Wrapping
+bool WrappingRepair::repairRow(double* const x) const {
+	return forEachViolation(x, lb.data(), ub.data(), [&](int const i){
+		if (x[i] < lb[i])
+			x[i] = ub[i] - std::fmod(lb[i] - x[i], std::abs(ub[i]-lb[i]));
+		else
+			x[i] = lb[i] + std::fmod(x[i] - ub[i], std::abs(ub[i]-lb[i]));
+	}) > 0;
+}
+
 void WrappingRepair::repair(Particle* const p) {
-	bool repaired = false;
-	for (int i = 0; i < D; i++){
-		if (p->getX(i) < lb[i]){
-			p->setX(i, ub[i] - std::fmod(lb[i] - p->getX(i), std::abs(ub[i]-lb[i])));
-			repairVelocityPost(p,i);
-			repaired=true;
-		} else if (p->getX(i) > ub[i]) {
-			p->setX(i, lb[i] + std::fmod(p->getX(i) - ub[i], std::abs(ub[i]-lb[i])));
-			repairVelocityPost(p,i);
-			repaired=true;
-		}
-	}
-	if (repaired) nCorrected++;
+	double* const x = p->modifyX();
+	if (forEachViolation(x, lb.data(), ub.data(), [&](int const i){
+		if (x[i] < lb[i])
+			x[i] = ub[i] - std::fmod(lb[i] - x[i], std::abs(ub[i]-lb[i]));
+		else
+			x[i] = lb[i] + std::fmod(x[i] - ub[i], std::abs(ub[i]-lb[i]));
+		repairVelocityPost(p,i);
+	}))
+		nCorrected++;
 }
 
 void WrappingRepair::repair(Solution* const p) {
-	bool repaired = false;
-	for (int i = 0; i < D; i++){
-		if (p->getX(i) < lb[i]){
-			p->setX(i, ub[i] - std::fmod(lb[i] - p->getX(i), std::abs(ub[i]-lb[i])));
-			repaired=true;
-		} else if (p->getX(i) > ub[i]) {
-			p->setX(i, lb[i] + std::fmod(p->getX(i) - ub[i], std::abs(ub[i]-lb[i])));
-			repaired=true;
-		}
-	}
-	if (repaired) nCorrected++;
+	if (repairRow(p->modifyX())) nCorrected++;
 }
 
+REPAIR_BATCH(WrappingRepair)
+
 // Transformation, adapted from https://github.com/psbiomech/c-cmaes
 TransformationRepair::TransformationRepair(std::vector<double>const lb, std::vector<double>const ub) 
-	:ConstraintHandler(lb,ub), DEConstraintHandler(lb,ub), PSOConstraintHandler(lb,ub), al(D), au(D), xlo(D), xhi(D), r(D){
+	:ConstraintHandler(lb,ub), DEConstraintHandler(lb,ub), PSOConstraintHandler(lb,ub), al(D), au(D), xlo(D), xhi(D), r(D),
+	innerLb(D), innerUb(D){
 	for (int i = 0; i < D; i++){
 		al[i] = std::min( (ub[i]-lb[i])/2., (1.+std::abs(lb[i]))/20. );
 		au[i] = std::min( (ub[i]-lb[i])/2., (1.+std::abs(ub[i]))/20. );
 		xlo[i] = lb[i] - 2. * al[i] - (ub[i] - lb[i]) / 2.;
 		xhi[i] = ub[i] + 2. * au[i] + (ub[i] - lb[i]) / 2.;
 		r[i] = 2.*(ub[i] - lb[i] + al[i] + au[i]);
+		innerLb[i] = lb[i] + al[i];
+		innerUb[i] = ub[i] - au[i];
 	}
 }
 
-// TODO maybe repair velocity in shift as well?
-void TransformationRepair::repair(Particle* const p) {
-	bool repaired = shift(p);
-	for (int i = 0; i < D; i++){
-		double const x_i = p->getX(i);
-		if (x_i < lb[i] + al[i]){
-			p->setX(i, lb[i] + pow(x_i - (lb[i] - al[i]),2.)/(4.*al[i]));
-			repairVelocityPost(p,i);
-			repaired=true;
-		}
-		else if (x_i > ub[i]-au[i]){
-			p->setX(i, ub[i] - pow(x_i - (ub[i] + au[i]),2.)/(4.*au[i]));
-			repairVelocityPost(p,i);
-			repaired=true;
-		}
-	}
-	if (repaired) nCorrected++;
+void TransformationRepair::transform(double* const x, int const i) const {
+	double x_i = x[i];
+	if (x_i < xlo[i])
+		x_i += r[i] * (1 + (int)((xlo[i] - x_i)/r[i]));
+	if (x_i > xhi[i])
+		x_i -= r[i] * (1 + (int)((x_i - xhi[i])/r[i]));
+	if (x_i < lb[i] - al[i])
+		x_i += 2. * (lb[i] - al[i] - x_i);
+	if (x_i > ub[i] + au[i])
+		x_i -= 2. * (x_i - ub[i] - au[i]);
+
+	if (x_i < lb[i] + al[i])
+		x_i = lb[i] + pow(x_i - (lb[i] - al[i]),2.)/(4.*al[i]);
+	else if (x_i > ub[i]-au[i])
+		x_i = ub[i] - pow(x_i - (ub[i] + au[i]),2.)/(4.*au[i]);
+	x[i] = x_i;
 }
 
-bool TransformationRepair::shift(Particle* const p) {
-	bool repaired = false;
-	for (int i = 0; i < D; i++){
-		if (p->getX(i) < xlo[i]) {
-			p->setX(i, p->getX(i) + r[i] * (1 + (int)((xlo[i] - p->getX(i))/r[i])) );
-			repairVelocityPost(p,i);
-			repaired=true;
-		}
-		if (p->getX(i) > xhi[i]) {
-			p->setX(i, p->getX(i) - r[i] * (1 + (int)((p->getX(i)-xhi[i])/r[i])) );
-			repairVelocityPost(p,i);
-			repaired=true;
-		}
+// Only coordinates outside the inner bounds are shifted or transformed
+bool TransformationRepair::repairRow(double* const x) const {
+	return forEachViolation(x, innerLb.data(), innerUb.data(), [&](int const i){
+		transform(x, i);
+	}) > 0;
+}
 
-		if (p->getX(i) < lb[i] - al[i]) {
-			p->setX(i, p->getX(i) + 2. * (lb[i] - al[i] - p->getX(i)));
-			repairVelocityPost(p,i);
-			repaired=true;
-		}
-		if (p->getX(i) > ub[i] + au[i]){
-			p->setX(i, p->getX(i) - 2. * (p->getX(i) - ub[i] - au[i]));
-			repairVelocityPost(p,i);
-			repaired=true;
-		}
-	}
-	return repaired;
+// TODO maybe repair velocity in shift as well?
+void TransformationRepair::repair(Particle* const p) {
+	double* const x = p->modifyX();
+	if (forEachViolation(x, innerLb.data(), innerUb.data(), [&](int const i){
+		transform(x, i);
+		repairVelocityPost(p,i);
+	}))
+		nCorrected++;
 }
 
 void TransformationRepair::repair(Solution* const p) {
-	bool repaired = shift(p);
-	for (int i = 0; i < D; i++){
-		double const x_i = p->getX(i);
-		if (x_i < lb[i] + al[i]){
-			p->setX(i, lb[i] + pow(x_i - (lb[i] - al[i]),2.)/(4.*al[i]));
-			repaired=true;
-		}
-		else if (x_i > ub[i]-au[i]){
-			p->setX(i, ub[i] - pow(x_i - (ub[i] + au[i]),2.)/(4.*au[i]));
-			repaired=true;
-		}
-	}
-	if (repaired) nCorrected++;
+	if (repairRow(p->modifyX())) nCorrected++;
 }
 
-bool TransformationRepair::shift(Solution* const p){
-	bool repaired = false;
-	for (int i = 0; i < D; i++){
-		if (p->getX(i) < xlo[i]) {
-			p->setX(i, p->getX(i) + r[i] * (1 + (int)((xlo[i] - p->getX(i))/r[i])));
-			repaired=true;
-		}
-		if (p->getX(i) > xhi[i]){
-			p->setX(i, p->getX(i) - r[i] * (1 + (int)((p->getX(i)-xhi[i])/r[i])));
-			repaired=true;
-		}
-
-		if (p->getX(i) < lb[i] - al[i]){
-			p->setX(i, p->getX(i) + 2. * (lb[i] - al[i] - p->getX(i)));
-			repaired=true;
-		}
-		if (p->getX(i) > ub[i] + au[i]){
-			p->setX(i, p->getX(i) - 2. * (p->getX(i) - ub[i] - au[i]));
-			repaired=true;
-		}
-	}
-	return repaired;
-}
+REPAIR_BATCH(TransformationRepair)
@@ -1,37 +1,236 @@
 #include "rng.h"
+#include "checkpoint.h"
 #include <algorithm>
+#include <cmath>
+
+namespace {
+	uint32_t const M0 = 0xD2511F53;
+	uint32_t const M1 = 0xCD9E8D57;
+	uint32_t const W0 = 0x9E3779B9;
+	uint32_t const W1 = 0xBB67AE85;
+	double const PI = 3.14159265358979323846;
+
+	uint64_t randomSeed(){
+		std::random_device dev;
+		return (uint64_t(dev()) << 32) | dev();
+	}
+}
 
 RNG::RNG()
-: rng(dev()), boolDist(0.5){
+: RNG(randomSeed()){
 
 } 
 
+RNG::RNG(uint64_t const seed, uint64_t const stream){
+	this->seed(seed, stream);
+}
+
+void RNG::seed(uint64_t const seed, uint64_t const stream){
+	key = seed;
+	seek(stream);
+}
+
+void RNG::seek(uint64_t const stream, uint64_t const counter){
+	this->stream = stream;
+	this->counter = counter;
+	used = 4;
+	hasSpare = false;
+}
+
+uint64_t RNG::getSeed() const {
+	return key;
+}
+
+void RNG::save(CheckpointWriter& writer) const {
+	writer.write(key);
+	writer.write(stream);
+	writer.write(counter);
+	for (uint32_t const word : block)
+		writer.write(word);
+	writer.write<int32_t>(used);
+	writer.write(spare);
+	writer.write<uint8_t>(hasSpare);
+}
+
+void RNG::load(CheckpointReader& reader){
+	reader.read(key);
+	reader.read(stream);
+	reader.read(counter);
+	for (uint32_t& word : block)
+		reader.read(word);
+	int32_t usedWords;
+	reader.read(usedWords);
+	used = usedWords;
+	reader.read(spare);
+	uint8_t spareFlag;
+	reader.read(spareFlag);
+	hasSpare = spareFlag;
+}
+
+void RNG::generateBlock(){
+	uint32_t c[4] = {uint32_t(counter), uint32_t(counter >> 32), uint32_t(stream), uint32_t(stream >> 32)};
+	uint32_t k0 = uint32_t(key), k1 = uint32_t(key >> 32);
+
+	for (int round = 0; round < 10; round++){
+		uint64_t const p0 = uint64_t(M0) * c[0];
+		uint64_t const p1 = uint64_t(M1) * c[2];
+		uint32_t const next[4] = {uint32_t(p1 >> 32) ^ c[1] ^ k0, uint32_t(p1), uint32_t(p0 >> 32) ^ c[3] ^ k1, uint32_t(p0)};
+		std::copy(next, next + 4, c);
+		k0 += W0;
+		k1 += W1;
+	}
+
+	std::copy(c, c + 4, block);
+	counter++;
+	used = 0;
+}
+
+uint32_t RNG::next32(){
+	if (used == 4)
+		generateBlock();
+	return block[used++];
+}
+
+uint64_t RNG::next64(){
+	uint64_t const hi = next32();
+	return (hi << 32) | next32();
+}
+
+uint64_t RNG::nextSeed(){
+	return next64();
+}
+
+double RNG::nextDouble(){
+	return (next64() >> 11) * (1.0 / 9007199254740992.0); // 53 random bits
+}
+
+double RNG::nextNormal(){
+	if (hasSpare){
+		hasSpare = false;
+		return spare;
+	}
+
+	double const r = std::sqrt(-2.0 * std::log(1.0 - nextDouble())); // Box-Muller
+	double const theta = 2.0 * PI * nextDouble();
+	spare = r * std::sin(theta);
+	hasSpare = true;
+	return r * std::cos(theta);
+}
+
 bool RNG::randBool(){
-	return boolDist(rng);
+	return next32() & 1;
 }
 
 double RNG::randDouble(double start, double end){
-	std::uniform_real_distribution<double> dist(start, end);
-	return dist(rng);
+	return start + (end - start) * nextDouble();
 }
 
 int RNG::randInt(int start, int end){
-	std::uniform_int_distribution<int> dist(start, end);
-	return dist(rng);
+	uint32_t const range = uint32_t(end - start) + 1;
+	uint64_t m = uint64_t(next32()) * range; // Lemire's unbiased bounded integers
+	if (uint32_t(m) < range){
+		uint32_t const threshold = -range % range;
+		while (uint32_t(m) < threshold)
+			m = uint64_t(next32()) * range;
+	}
+	return start + int(m >> 32);
 }
 
 double RNG::normalDistribution(double mean, double stdDev){
-	std::normal_distribution<double> N(mean, stdDev);
-	return N(rng);
+	return mean + stdDev * nextNormal();
 }
 
 double RNG::cauchyDistribution(double a, double b){
-	std::cauchy_distribution<double> C(a,b);
-	return C(rng);
+	return a + b * std::tan(PI * (nextDouble() - 0.5));
 }
 
 void RNG::shuffle(std::vector<double>::iterator first, std::vector<double>::iterator last){
-	std::shuffle(first, last, rng);
+	for (int i = int(last - first) - 1; i > 0; i--)
+		std::iter_swap(first + i, first + randInt(0, i));
+}
+
+void RNG::fillUniform(double* const out, int const n, double const start, double const end){
+	double const width = end - start;
+	for (int i = 0; i < n; i++)
+		out[i] = start + width * nextDouble();
+}
+
+void RNG::fillNormal(double* const out, int const n, double const mean, double const stdDev){
+	int i = 0;
+	if (hasSpare && n > 0){
+		out[i++] = mean + stdDev * spare;
+		hasSpare = false;
+	}
+
+	for (; i + 1 < n; i += 2){
+		double const r = std::sqrt(-2.0 * std::log(1.0 - nextDouble()));
+		double const theta = 2.0 * PI * nextDouble();
+		out[i] = mean + stdDev * r * std::cos(theta);
+		out[i+1] = mean + stdDev * r * std::sin(theta);
+	}
+
+	if (i < n)
+		out[i] = normalDistribution(mean, stdDev);
+}
+
+void RNG::fillCauchy(double* const out, int const n, double const a, double const b){
+	for (int i = 0; i < n; i++)
+		out[i] = a + b * std::tan(PI * (nextDouble() - 0.5));
+}
+
+void RNG::fillTruncatedNormal(double* const out, int const n, double const mean, double const stdDev, double const lower){
+	int accepted = 0;
+	while (accepted < n){
+		fillNormal(out + accepted, n - accepted, mean, stdDev);
+		for (int i = accepted; i < n; i++) // The values are i.i.d., so packing them does not bias the order
+			if (out[i] > lower)
+				out[accepted++] = out[i];
+	}
+}
+
+void RNG::fillTruncatedCauchy(double* const out, int const n, double const* const a, double const b, double const lower){
+	for (int i = 0; i < n; i++){
+		double const cdfLower = 0.5 + std::atan((lower - a[i]) / b) / PI;
+		double const u = cdfLower + (1.0 - cdfLower) * (1.0 - nextDouble()); // In (cdfLower, 1]
+		out[i] = a[i] + b * std::tan(PI * (u - 0.5));
+	}
+}
+
+void RNG::fillBernoulli(uint64_t* const bits, int const n, double const p){
+	int const words = (n + 63) / 64;
+	bool const invert = p > 0.5; // Place the rarer outcome
+	double const q = invert ? 1.0 - p : p;
+
+	if (q < 0.125){
+		std::fill(bits, bits + words, invert ? ~uint64_t(0) : 0);
+		if (q > 0){
+			double const logQ = std::log1p(-q);
+			for (double j = std::floor(std::log(1.0 - nextDouble()) / logQ); j < n;
+					j += 1.0 + std::floor(std::log(1.0 - nextDouble()) / logQ))
+				bits[int(j) / 64] ^= uint64_t(1) << (int(j) % 64);
+		}
+	} else {
+		uint64_t const threshold = uint64_t(p * 4294967296.0);
+		for (int w = 0; w < words; w++){
+			int const m = std::min(64, n - 64 * w);
+			uint64_t word = 0;
+			for (int b = 0; b < m; b++)
+				word |= uint64_t(next32() < threshold) << b;
+			bits[w] = word;
+		}
+	}
+
+	if (n % 64 != 0)
+		bits[words - 1] &= (uint64_t(1) << (n % 64)) - 1;
+}
+
+int RNG::geometric(double const p, int const max){
+	if (p <= 0)
+		return 0;
+	if (p >= 1)
+		return max;
+	double const k = std::floor(std::log(1.0 - nextDouble()) / std::log(p));
+	return k < max ? int(k) : max;
 }
 
-RNG rng; //Global Random Number Generator
\ No newline at end of file
+thread_local RNG rng; //Per-thread Random Number Generator
@@ -0,0 +1,526 @@
+#include "simd.h"
+#include <immintrin.h>
+
+// Contracting a*b+c into an FMA would round differently from the scalar
+// kernels, so it is disabled for the whole file.
+#pragma GCC optimize("fp-contract=off")
+
+// Every kernel is a template on N. With N > 0 the dimension is the compile-time
+// constant N, so the loops are fully unrolled; N = 0 takes D at runtime.
+
+namespace {
+	/*		Scalar		*/
+	template <int N>
+	void scaleScalar(double* const x, double const a, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		for (int i = 0; i < D; i++)
+			x[i] *= a;
+	}
+
+	template <int N>
+	void addScalar(double const* const a, double const* const b, double* const out, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		for (int i = 0; i < D; i++)
+			out[i] = a[i] + b[i];
+	}
+
+	template <int N>
+	void subtractScalar(double const* const a, double const* const b, double* const out, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		for (int i = 0; i < D; i++)
+			out[i] = a[i] - b[i];
+	}
+
+	template <int N>
+	void multiplyScalar(double* const x, double const* const r, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		for (int i = 0; i < D; i++)
+			x[i] *= r[i];
+	}
+
+	// Sums in eight interleaved lanes, like the vector kernels, so that all of them round the same way
+	double reduce(double const* const lanes){
+		return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+	}
+
+	double squaredDistanceTail(double sum, double const* const a, double const* const b, int i, int const D){
+		for (; i < D; i++)
+			sum += (a[i] - b[i]) * (a[i] - b[i]);
+		return sum;
+	}
+
+	template <int N>
+	double squaredDistanceScalar(double const* const a, double const* const b, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		double lanes[8] = {0., 0., 0., 0., 0., 0., 0., 0.};
+		int i = 0;
+		for (; i + 8 <= D; i += 8)
+			for (int j = 0; j < 8; j++)
+				lanes[j] += (a[i+j] - b[i+j]) * (a[i+j] - b[i+j]);
+		return squaredDistanceTail(reduce(lanes), a, b, i, D);
+	}
+
+	template <int N>
+	void addScaledDifferenceScalar(double const* const a, double const* const b, double const* const c,
+			double const F, double* const out, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		for (int i = 0; i < D; i++)
+			out[i] = a[i] + (b[i] - c[i]) * F;
+	}
+
+	template <int N>
+	void addScaledDifferencesScalar(double const* const a, double const* const b, double const* const c,
+			double const* const d, double const* const e, double const F, double* const out, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		for (int i = 0; i < D; i++)
+			out[i] = a[i] + (((b[i] - c[i]) + d[i]) - e[i]) * F;
+	}
+
+	template <int N>
+	void addScaledDifferences3Scalar(double const* const a, double const* const b, double const* const c, double const* const d,
+			double const* const e, double const* const f, double const* const g, double const F, double* const out, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		for (int i = 0; i < D; i++)
+			out[i] = a[i] + (((((b[i] - c[i]) + d[i]) - e[i]) + f[i]) - g[i]) * F;
+	}
+
+	template <int N>
+	uint64_t boundViolationsScalar(double const* const x, double const* const lb, double const* const ub, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		uint64_t bits = 0;
+		for (int i = 0; i < D; i++)
+			bits |= uint64_t(x[i] < lb[i] || x[i] > ub[i]) << i;
+		return bits;
+	}
+
+	template <int N>
+	void selectScalar(double const* const a, double const* const b, uint64_t const* const mask, double* const out, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		for (int i = 0; i < D; i++)
+			out[i] = (mask[i / 64] >> (i % 64)) & 1 ? b[i] : a[i];
+	}
+
+	template <int N>
+	void updateVelocityScalar(double* const v, double const* const x, double const* const p, double const* const g,
+			double const* const r1, double const* const r2, double const w, double const c, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		for (int i = 0; i < D; i++)
+			v[i] = ((v[i] * w + (p[i] - x[i]) * r1[i]) + (g[i] - x[i]) * r2[i]) * c;
+	}
+
+	template <int N>
+	void fullyInformedVelocityScalar(double* const v, double const* const x, double const* const* const p,
+			double const* const phi, int const n, double const c, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		double const inverse = 1.0 / n;
+		for (int i = 0; i < D; i++){
+			double sum = 0.;
+			for (int k = 0; k < n; k++)
+				sum = sum + (p[k][i] - x[i]) * phi[k];
+			v[i] = (v[i] + sum * inverse) * c;
+		}
+	}
+
+	/*		AVX2		*/
+	template <int N>
+	__attribute__((target("avx2")))
+	void scaleAVX2(double* const x, double const a, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		__m256d const va = _mm256_set1_pd(a);
+		int i = 0;
+		for (; i + 4 <= D; i += 4)
+			_mm256_storeu_pd(x + i, _mm256_mul_pd(_mm256_loadu_pd(x + i), va));
+		for (; i < D; i++)
+			x[i] *= a;
+	}
+
+	template <int N>
+	__attribute__((target("avx2")))
+	void addAVX2(double const* const a, double const* const b, double* const out, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		int i = 0;
+		for (; i + 4 <= D; i += 4)
+			_mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+		for (; i < D; i++)
+			out[i] = a[i] + b[i];
+	}
+
+	template <int N>
+	__attribute__((target("avx2")))
+	void subtractAVX2(double const* const a, double const* const b, double* const out, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		int i = 0;
+		for (; i + 4 <= D; i += 4)
+			_mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+		for (; i < D; i++)
+			out[i] = a[i] - b[i];
+	}
+
+	template <int N>
+	__attribute__((target("avx2")))
+	void multiplyAVX2(double* const x, double const* const r, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		int i = 0;
+		for (; i + 4 <= D; i += 4)
+			_mm256_storeu_pd(x + i, _mm256_mul_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(r + i)));
+		for (; i < D; i++)
+			x[i] *= r[i];
+	}
+
+	template <int N>
+	__attribute__((target("avx2")))
+	double squaredDistanceAVX2(double const* const a, double const* const b, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		__m256d lo = _mm256_setzero_pd(), hi = _mm256_setzero_pd(); // Lanes 0-3 and 4-7
+		int i = 0;
+		for (; i + 8 <= D; i += 8){
+			__m256d const dlo = _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+			__m256d const dhi = _mm256_sub_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4));
+			lo = _mm256_add_pd(lo, _mm256_mul_pd(dlo, dlo));
+			hi = _mm256_add_pd(hi, _mm256_mul_pd(dhi, dhi));
+		}
+		double lanes[8];
+		_mm256_storeu_pd(lanes, lo);
+		_mm256_storeu_pd(lanes + 4, hi);
+		return squaredDistanceTail(reduce(lanes), a, b, i, D);
+	}
+
+	template <int N>
+	__attribute__((target("avx2")))
+	void addScaledDifferenceAVX2(double const* const a, double const* const b, double const* const c,
+			double const F, double* const out, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		__m256d const vF = _mm256_set1_pd(F);
+		int i = 0;
+		for (; i + 4 <= D; i += 4){
+			__m256d const diff = _mm256_sub_pd(_mm256_loadu_pd(b + i), _mm256_loadu_pd(c + i));
+			_mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_mul_pd(diff, vF)));
+		}
+		for (; i < D; i++)
+			out[i] = a[i] + (b[i] - c[i]) * F;
+	}
+
+	template <int N>
+	__attribute__((target("avx2")))
+	void addScaledDifferencesAVX2(double const* const a, double const* const b, double const* const c,
+			double const* const d, double const* const e, double const F, double* const out, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		__m256d const vF = _mm256_set1_pd(F);
+		int i = 0;
+		for (; i + 4 <= D; i += 4){
+			__m256d diff = _mm256_sub_pd(_mm256_loadu_pd(b + i), _mm256_loadu_pd(c + i));
+			diff = _mm256_sub_pd(_mm256_add_pd(diff, _mm256_loadu_pd(d + i)), _mm256_loadu_pd(e + i));
+			_mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_mul_pd(diff, vF)));
+		}
+		for (; i < D; i++)
+			out[i] = a[i] + (((b[i] - c[i]) + d[i]) - e[i]) * F;
+	}
+
+	template <int N>
+	__attribute__((target("avx2")))
+	void addScaledDifferences3AVX2(double const* const a, double const* const b, double const* const c, double const* const d,
+			double const* const e, double const* const f, double const* const g, double const F, double* const out, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		__m256d const vF = _mm256_set1_pd(F);
+		int i = 0;
+		for (; i + 4 <= D; i += 4){
+			__m256d diff = _mm256_sub_pd(_mm256_loadu_pd(b + i), _mm256_loadu_pd(c + i));
+			diff = _mm256_sub_pd(_mm256_add_pd(diff, _mm256_loadu_pd(d + i)), _mm256_loadu_pd(e + i));
+			diff = _mm256_sub_pd(_mm256_add_pd(diff, _mm256_loadu_pd(f + i)), _mm256_loadu_pd(g + i));
+			_mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_mul_pd(diff, vF)));
+		}
+		for (; i < D; i++)
+			out[i] = a[i] + (((((b[i] - c[i]) + d[i]) - e[i]) + f[i]) - g[i]) * F;
+	}
+
+	template <int N>
+	__attribute__((target("avx2")))
+	uint64_t boundViolationsAVX2(double const* const x, double const* const lb, double const* const ub, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		uint64_t bits = 0;
+		int i = 0;
+		for (; i + 4 <= D; i += 4){
+			__m256d const xi = _mm256_loadu_pd(x + i);
+			__m256d const outside = _mm256_or_pd(_mm256_cmp_pd(xi, _mm256_loadu_pd(lb + i), _CMP_LT_OQ),
+				_mm256_cmp_pd(xi, _mm256_loadu_pd(ub + i), _CMP_GT_OQ));
+			bits |= uint64_t(_mm256_movemask_pd(outside)) << i;
+		}
+		for (; i < D; i++)
+			bits |= uint64_t(x[i] < lb[i] || x[i] > ub[i]) << i;
+		return bits;
+	}
+
+	template <int N>
+	__attribute__((target("avx2")))
+	void selectAVX2(double const* const a, double const* const b, uint64_t const* const mask, double* const out, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		__m256i const laneBits = _mm256_set_epi64x(8, 4, 2, 1);
+		int i = 0;
+		for (; i + 4 <= D; i += 4){ // Four bits never straddle two words
+			__m256i const bits = _mm256_set1_epi64x((mask[i / 64] >> (i % 64)) & 0xF);
+			__m256d const fromB = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(bits, laneBits), laneBits));
+			_mm256_storeu_pd(out + i, _mm256_blendv_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), fromB));
+		}
+		for (; i < D; i++)
+			out[i] = (mask[i / 64] >> (i % 64)) & 1 ? b[i] : a[i];
+	}
+
+	template <int N>
+	__attribute__((target("avx2")))
+	void updateVelocityAVX2(double* const v, double const* const x, double const* const p, double const* const g,
+			double const* const r1, double const* const r2, double const w, double const c, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		__m256d const vw = _mm256_set1_pd(w), vc = _mm256_set1_pd(c);
+		int i = 0;
+		for (; i + 4 <= D; i += 4){
+			__m256d const xi = _mm256_loadu_pd(x + i);
+			__m256d const cognitive = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(p + i), xi), _mm256_loadu_pd(r1 + i));
+			__m256d const social = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(g + i), xi), _mm256_loadu_pd(r2 + i));
+			__m256d const vi = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(v + i), vw), cognitive), social);
+			_mm256_storeu_pd(v + i, _mm256_mul_pd(vi, vc));
+		}
+		for (; i < D; i++)
+			v[i] = ((v[i] * w + (p[i] - x[i]) * r1[i]) + (g[i] - x[i]) * r2[i]) * c;
+	}
+
+	template <int N>
+	__attribute__((target("avx2")))
+	void fullyInformedVelocityAVX2(double* const v, double const* const x, double const* const* const p,
+			double const* const phi, int const n, double const c, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		double const inverse = 1.0 / n;
+		__m256d const vInverse = _mm256_set1_pd(inverse), vc = _mm256_set1_pd(c);
+		int i = 0;
+		for (; i + 4 <= D; i += 4){
+			__m256d const xi = _mm256_loadu_pd(x + i);
+			__m256d sum = _mm256_setzero_pd();
+			for (int k = 0; k < n; k++)
+				sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(p[k] + i), xi), _mm256_set1_pd(phi[k])));
+			_mm256_storeu_pd(v + i, _mm256_mul_pd(_mm256_add_pd(_mm256_loadu_pd(v + i), _mm256_mul_pd(sum, vInverse)), vc));
+		}
+		for (; i < D; i++){
+			double sum = 0.;
+			for (int k = 0; k < n; k++)
+				sum = sum + (p[k][i] - x[i]) * phi[k];
+			v[i] = (v[i] + sum * inverse) * c;
+		}
+	}
+
+	/*		AVX-512, remainders are handled with masked loads and stores		*/
+	__attribute__((target("avx512f")))
+	__mmask8 tailMask(int const n){
+		return __mmask8((1u << n) - 1);
+	}
+
+	template <int N>
+	__attribute__((target("avx512f")))
+	void scaleAVX512(double* const x, double const a, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		__m512d const va = _mm512_set1_pd(a);
+		for (int i = 0; i < D; i += 8){
+			__mmask8 const m = D - i >= 8 ? 0xFF : tailMask(D - i);
+			_mm512_mask_storeu_pd(x + i, m, _mm512_mul_pd(_mm512_maskz_loadu_pd(m, x + i), va));
+		}
+	}
+
+	template <int N>
+	__attribute__((target("avx512f")))
+	void addAVX512(double const* const a, double const* const b, double* const out, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		for (int i = 0; i < D; i += 8){
+			__mmask8 const m = D - i >= 8 ? 0xFF : tailMask(D - i);
+			_mm512_mask_storeu_pd(out + i, m, _mm512_add_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i)));
+		}
+	}
+
+	template <int N>
+	__attribute__((target("avx512f")))
+	void subtractAVX512(double const* const a, double const* const b, double* const out, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		for (int i = 0; i < D; i += 8){
+			__mmask8 const m = D - i >= 8 ? 0xFF : tailMask(D - i);
+			_mm512_mask_storeu_pd(out + i, m, _mm512_sub_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i)));
+		}
+	}
+
+	template <int N>
+	__attribute__((target("avx512f")))
+	void multiplyAVX512(double* const x, double const* const r, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		for (int i = 0; i < D; i += 8){
+			__mmask8 const m = D - i >= 8 ? 0xFF : tailMask(D - i);
+			_mm512_mask_storeu_pd(x + i, m, _mm512_mul_pd(_mm512_maskz_loadu_pd(m, x + i), _mm512_maskz_loadu_pd(m, r + i)));
+		}
+	}
+
+	template <int N>
+	__attribute__((target("avx512f")))
+	double squaredDistanceAVX512(double const* const a, double const* const b, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		__m512d sum = _mm512_setzero_pd();
+		int i = 0;
+		for (; i + 8 <= D; i += 8){
+			__m512d const diff = _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i));
+			sum = _mm512_add_pd(sum, _mm512_mul_pd(diff, diff));
+		}
+		double lanes[8];
+		_mm512_storeu_pd(lanes, sum);
+		return squaredDistanceTail(reduce(lanes), a, b, i, D);
+	}
+
+	template <int N>
+	__attribute__((target("avx512f")))
+	void addScaledDifferenceAVX512(double const* const a, double const* const b, double const* const c,
+			double const F, double* const out, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		__m512d const vF = _mm512_set1_pd(F);
+		for (int i = 0; i < D; i += 8){
+			__mmask8 const m = D - i >= 8 ? 0xFF : tailMask(D - i);
+			__m512d const diff = _mm512_sub_pd(_mm512_maskz_loadu_pd(m, b + i), _mm512_maskz_loadu_pd(m, c + i));
+			_mm512_mask_storeu_pd(out + i, m, _mm512_add_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_mul_pd(diff, vF)));
+		}
+	}
+
+	template <int N>
+	__attribute__((target("avx512f")))
+	void addScaledDifferencesAVX512(double const* const a, double const* const b, double const* const c,
+			double const* const d, double const* const e, double const F, double* const out, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		__m512d const vF = _mm512_set1_pd(F);
+		for (int i = 0; i < D; i += 8){
+			__mmask8 const m = D - i >= 8 ? 0xFF : tailMask(D - i);
+			__m512d diff = _mm512_sub_pd(_mm512_maskz_loadu_pd(m, b + i), _mm512_maskz_loadu_pd(m, c + i));
+			diff = _mm512_sub_pd(_mm512_add_pd(diff, _mm512_maskz_loadu_pd(m, d + i)), _mm512_maskz_loadu_pd(m, e + i));
+			_mm512_mask_storeu_pd(out + i, m, _mm512_add_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_mul_pd(diff, vF)));
+		}
+	}
+
+	template <int N>
+	__attribute__((target("avx512f")))
+	void addScaledDifferences3AVX512(double const* const a, double const* const b, double const* const c, double const* const d,
+			double const* const e, double const* const f, double const* const g, double const F, double* const out, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		__m512d const vF = _mm512_set1_pd(F);
+		for (int i = 0; i < D; i += 8){
+			__mmask8 const m = D - i >= 8 ? 0xFF : tailMask(D - i);
+			__m512d diff = _mm512_sub_pd(_mm512_maskz_loadu_pd(m, b + i), _mm512_maskz_loadu_pd(m, c + i));
+			diff = _mm512_sub_pd(_mm512_add_pd(diff, _mm512_maskz_loadu_pd(m, d + i)), _mm512_maskz_loadu_pd(m, e + i));
+			diff = _mm512_sub_pd(_mm512_add_pd(diff, _mm512_maskz_loadu_pd(m, f + i)), _mm512_maskz_loadu_pd(m, g + i));
+			_mm512_mask_storeu_pd(out + i, m, _mm512_add_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_mul_pd(diff, vF)));
+		}
+	}
+
+	template <int N>
+	__attribute__((target("avx512f")))
+	uint64_t boundViolationsAVX512(double const* const x, double const* const lb, double const* const ub, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		uint64_t bits = 0;
+		for (int i = 0; i < D; i += 8){
+			__mmask8 const m = D - i >= 8 ? 0xFF : tailMask(D - i);
+			__m512d const xi = _mm512_maskz_loadu_pd(m, x + i);
+			__mmask8 const outside = _mm512_mask_cmp_pd_mask(m, xi, _mm512_maskz_loadu_pd(m, lb + i), _CMP_LT_OQ)
+				| _mm512_mask_cmp_pd_mask(m, xi, _mm512_maskz_loadu_pd(m, ub + i), _CMP_GT_OQ);
+			bits |= uint64_t(outside) << i;
+		}
+		return bits;
+	}
+
+	template <int N>
+	__attribute__((target("avx512f")))
+	void selectAVX512(double const* const a, double const* const b, uint64_t const* const mask, double* const out, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		for (int i = 0; i < D; i += 8){
+			__mmask8 const m = D - i >= 8 ? 0xFF : tailMask(D - i);
+			__mmask8 const fromB = __mmask8(mask[i / 64] >> (i % 64));
+			__m512d const blend = _mm512_mask_blend_pd(fromB, _mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i));
+			_mm512_mask_storeu_pd(out + i, m, blend);
+		}
+	}
+
+	template <int N>
+	__attribute__((target("avx512f")))
+	void updateVelocityAVX512(double* const v, double const* const x, double const* const p, double const* const g,
+			double const* const r1, double const* const r2, double const w, double const c, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		__m512d const vw = _mm512_set1_pd(w), vc = _mm512_set1_pd(c);
+		for (int i = 0; i < D; i += 8){
+			__mmask8 const m = D - i >= 8 ? 0xFF : tailMask(D - i);
+			__m512d const xi = _mm512_maskz_loadu_pd(m, x + i);
+			__m512d const cognitive = _mm512_mul_pd(_mm512_sub_pd(_mm512_maskz_loadu_pd(m, p + i), xi), _mm512_maskz_loadu_pd(m, r1 + i));
+			__m512d const social = _mm512_mul_pd(_mm512_sub_pd(_mm512_maskz_loadu_pd(m, g + i), xi), _mm512_maskz_loadu_pd(m, r2 + i));
+			__m512d const vi = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(_mm512_maskz_loadu_pd(m, v + i), vw), cognitive), social);
+			_mm512_mask_storeu_pd(v + i, m, _mm512_mul_pd(vi, vc));
+		}
+	}
+
+	template <int N>
+	__attribute__((target("avx512f")))
+	void fullyInformedVelocityAVX512(double* const v, double const* const x, double const* const* const p,
+			double const* const phi, int const n, double const c, int const runtimeD){
+		int const D = N > 0 ? N : runtimeD;
+		__m512d const vInverse = _mm512_set1_pd(1.0 / n), vc = _mm512_set1_pd(c);
+		for (int i = 0; i < D; i += 8){
+			__mmask8 const m = D - i >= 8 ? 0xFF : tailMask(D - i);
+			__m512d const xi = _mm512_maskz_loadu_pd(m, x + i);
+			__m512d sum = _mm512_setzero_pd();
+			for (int k = 0; k < n; k++)
+				sum = _mm512_add_pd(sum, _mm512_mul_pd(_mm512_sub_pd(_mm512_maskz_loadu_pd(m, p[k] + i), xi), _mm512_set1_pd(phi[k])));
+			_mm512_mask_storeu_pd(v + i, m, _mm512_mul_pd(_mm512_add_pd(_mm512_maskz_loadu_pd(m, v + i), _mm512_mul_pd(sum, vInverse)), vc));
+		}
+	}
+
+#define KERNELS(NAME, ISA, N) {NAME, scale##ISA<N>, add##ISA<N>, subtract##ISA<N>, multiply##ISA<N>, squaredDistance##ISA<N>,\
+		addScaledDifference##ISA<N>, addScaledDifferences##ISA<N>, addScaledDifferences3##ISA<N>, boundViolations##ISA<N>, select##ISA<N>, updateVelocity##ISA<N>,\
+		fullyInformedVelocity##ISA<N>}
+#define KERNEL_TABLES(NAME, ISA) {KERNELS(NAME, ISA, 0), KERNELS(NAME, ISA, 2), KERNELS(NAME, ISA, 5),\
+		KERNELS(NAME, ISA, 10), KERNELS(NAME, ISA, 20), KERNELS(NAME, ISA, 40), KERNELS(NAME, ISA, 100)}
+
+	// The first table of every ISA takes any D, the others only fixedDimensions[k]
+	int const fixedDimensions[] = {0, 2, 5, 10, 20, 40, 100};
+	int const maxFixedDimension = 100;
+	VectorKernels const scalarKernels[] = KERNEL_TABLES("scalar", Scalar);
+	VectorKernels const avx2Kernels[] = KERNEL_TABLES("avx2", AVX2);
+	VectorKernels const avx512Kernels[] = KERNEL_TABLES("avx512", AVX512);
+
+	// Position of the table of D in the tables of an ISA, 0 if D has none
+	int dimensionSlot(int const D){
+		for (int k = 1; k < int(sizeof(fixedDimensions) / sizeof(*fixedDimensions)); k++)
+			if (fixedDimensions[k] == D)
+				return k;
+		return 0;
+	}
+
+	VectorKernels const* detectVectorKernels(){
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f"))
+			return avx512Kernels;
+		else if (__builtin_cpu_supports("avx2"))
+			return avx2Kernels;
+		else
+			return scalarKernels;
+	}
+
+	// Tables of the selected ISA. Detected on first use rather than by a static initializer, so that
+	// static initializers in other files can use the kernels as well.
+	VectorKernels const*& selectedKernels(){
+		static VectorKernels const* kernels = detectVectorKernels();
+		return kernels;
+	}
+}
+
+bool setVectorKernels(std::string const isa){
+	__builtin_cpu_init();
+	if (isa == "scalar")
+		selectedKernels() = scalarKernels;
+	else if (isa == "avx2" && __builtin_cpu_supports("avx2"))
+		selectedKernels() = avx2Kernels;
+	else if (isa == "avx512" && __builtin_cpu_supports("avx512f"))
+		selectedKernels() = avx512Kernels;
+	else
+		return false;
+	return true;
+}
+
+VectorKernels const* getVectorKernels(int const D){
+	return &selectedKernels()[D <= maxFixedDimension ? dimensionSlot(D) : 0];
+}
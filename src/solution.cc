@@ -1,42 +1,93 @@
 #include "solution.h"
+#include "population.h"
 #include "rng.h"
 #include <limits>
+#include <algorithm>
+
+Solution::Solution(int const D)
+	: ownX(D), ownFitness(std::numeric_limits<double>::max()), x(ownX.data()), fitness(&ownFitness), evaluated(false), D(D){}
+
+Solution::Solution(std::vector<double> const& x)
+	: ownX(x), ownFitness(std::numeric_limits<double>::max()), x(ownX.data()), fitness(&ownFitness), evaluated(false), D(x.size()){}
+
+Solution::Solution(std::vector<double>&& x)
+	: ownX(std::move(x)), ownFitness(std::numeric_limits<double>::max()), x(ownX.data()), fitness(&ownFitness), evaluated(false), D(ownX.size()){}
+
+Solution::Solution(Population& population, int const i)
+	: ownFitness(std::numeric_limits<double>::max()), x(population.getX(i)), fitness(&population.fitness[i]), evaluated(false), D(population.D){}
+
+Solution::Solution(Solution const& other)
+	: ownX(other.ownX), ownFitness(other.ownFitness), x(other.x), fitness(other.fitness), evaluated(other.evaluated), D(other.D){
+	if (!ownX.empty()){ // Copy of an owning solution
+		x = ownX.data();
+		fitness = &ownFitness;
+	}
+}
 
-Solution::Solution(int const D) : x(D),  evaluated(false), fitness(std::numeric_limits<double>::max()), D(D){}
-Solution::Solution(std::vector<double> const x): x(x), evaluated(false), fitness(std::numeric_limits<double>::max()), D(x.size()){}
 Solution::~Solution(){};
 
-void Solution::setX(std::vector<double> x, double fitness){
-	this->x = x;
-	this->fitness = fitness;
+void Solution::setX(std::vector<double> const& x, double fitness){
+	std::copy(x.begin(), x.end(), this->x);
+	*this->fitness = fitness;
 }
 
-void Solution::setX(std::vector<double> x){
-	this->x = x;
+void Solution::setX(std::vector<double>&& x, double fitness){
+	take(std::move(x));
+	*this->fitness = fitness;
+}
+
+void Solution::setX(ConstSpan const x, double fitness){
+	std::copy(x.begin(), x.end(), this->x);
+	*this->fitness = fitness;
+}
+
+void Solution::setX(std::vector<double> const& x){
+	std::copy(x.begin(), x.end(), this->x);
 	evaluated=false;
 }
 
+void Solution::setX(std::vector<double>&& x){
+	take(std::move(x));
+	evaluated=false;
+}
+
+void Solution::take(std::vector<double>&& x){
+	if (!ownX.empty()){ // Take over the buffer instead of copying it
+		ownX = std::move(x);
+		this->x = ownX.data();
+	} else 
+		std::copy(x.begin(), x.end(), this->x);
+}
+
 double Solution::getFitness() const{
-	return fitness;
+	return *fitness;
+}
+
+bool Solution::isEvaluated() const {
+	return evaluated;
 }
 
 void Solution::setFitness(double const f){
-	this->fitness = f;
+	*this->fitness = f;
 	evaluated=true;
 }
 
 double Solution::evaluate(std::shared_ptr<IOHprofiler_problem<double> > problem, std::shared_ptr<IOHprofiler_csv_logger> logger) {
 	if (!evaluated){
 		evaluated = true;		
-		fitness = problem->evaluate(x);
+		*fitness = problem->evaluate(getX());
 		logger->do_log(problem->loggerCOCOInfo());
 	} 
 
-	return fitness;
+	return *fitness;
 }
 
 std::vector<double> Solution::getX() const {
-	return x;
+	return std::vector<double>(x, x + D);
+}
+
+ConstSpan Solution::getXView() const {
+	return ConstSpan(x, D);
 }
 
 std::string Solution::positionString() const {
@@ -51,26 +102,32 @@ std::string Solution::positionString() const {
 }
 
 void Solution::randomize(std::vector<double> const lowerBounds, std::vector<double> const upperBounds){
+	rng.fillUniform(x, D, 0, 1);
 	for (int i = 0; i < D; i++)
-		x[i] = rng.randDouble(lowerBounds[i], upperBounds[i]);
+		x[i] = lowerBounds[i] + x[i] * (upperBounds[i] - lowerBounds[i]);
 
 	evaluated=false;
 }
 
 bool Solution::operator < (const Solution& s) const {
-	return fitness < s.getFitness();
+	return *fitness < s.getFitness();
 }
 
 void Solution::setX(int const dim, double const val){
 	x[dim] = val;
 }
 
+double* Solution::modifyX(){
+	evaluated=false;
+	return x;
+}
+
 double Solution::getX(int const dim) const {
 	return x[dim];
 }
 
 void Solution::copy(Solution const* const other){
-	x = other->x;
+	std::copy(other->x, other->x + D, x);
 	evaluated = other->evaluated;
-	fitness = other->fitness;
+	*fitness = *other->fitness;
 }
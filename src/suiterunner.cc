@@ -0,0 +1,112 @@
+#include <IOHprofiler_experimenter.h>
+#include "suiterunner.h"
+#include "threadpool.h"
+#include "batchproblem.h"
+
+SuiteRunner::SuiteRunner(std::string const configFile, int const threads, int const evaluationThreads)
+	: configFile(configFile), threads(threads), evaluationThreads(evaluationThreads){
+}
+
+void SuiteRunner::add(std::string const name, Job const job){
+	names.push_back(name);
+	jobs.push_back(job);
+}
+
+std::vector<int> SuiteRunner::all(int const size, std::vector<int> const& configurations){
+	if (!configurations.empty())
+		return configurations;
+
+	std::vector<int> indices(size);
+	for (int i = 0; i < size; i++)
+		indices[i] = i;
+	return indices;
+}
+
+void SuiteRunner::add(DESuite& suite, std::function<void(DifferentialEvolution&, Problem const, CsvLogger const)> const run,
+		std::vector<int> const configurations){
+	for (int const i : all(suite.size(), configurations)){
+		DifferentialEvolution const de = suite.getDE(i);
+		add(de.getIdString(), [=](Problem const problem, CsvLogger const logger, std::string const logSuffix){
+			DifferentialEvolution copy = de;
+			copy.setLogSuffix(logSuffix);
+			copy.setEvaluationThreads(evaluationThreads);
+			run(copy, problem, logger);
+		});
+	}
+}
+
+void SuiteRunner::add(ParticleSwarmSuite& suite, std::function<void(ParticleSwarm&, Problem const, CsvLogger const)> const run,
+		std::vector<int> const configurations){
+	for (int const i : all(suite.size(), configurations)){
+		ParticleSwarm const pso = suite.getParticleSwarm(i);
+		add(pso.getIdString(), [=](Problem const problem, CsvLogger const logger, std::string const logSuffix){
+			ParticleSwarm copy = pso;
+			copy.setLogSuffix(logSuffix);
+			run(copy, problem, logger);
+		});
+	}
+}
+
+int SuiteRunner::getThreadSlot(){
+	std::lock_guard<std::mutex> lock(mutex);
+	auto const found = threadSlots.find(std::this_thread::get_id());
+	if (found != threadSlots.end())
+		return found->second;
+
+	int const slot = threadSlots.size();
+	threadSlots[std::this_thread::get_id()] = slot;
+	return slot;
+}
+
+SuiteRunner::CsvLogger SuiteRunner::getLogger(IOHprofiler_configuration const& conf, int const configuration, int const slot){
+	std::lock_guard<std::mutex> lock(mutex);
+	std::pair<int, CsvLogger>& current = loggers[slot];
+	CsvLogger& logger = current.second;
+	if (!logger || current.first != configuration){
+		logger.reset(); // Closes the files of the previous configuration
+		current.first = configuration;
+		std::string const name = names[configuration];
+		logger = std::make_shared<IOHprofiler_csv_logger>(conf.get_output_directory(),
+				name + "_t" + std::to_string(slot), name, conf.get_algorithm_info());
+		logger->set_complete_flag(conf.get_complete_triggers());
+		logger->set_interval(conf.get_number_interval_triggers());
+		logger->set_time_points(conf.get_base_evaluation_triggers(), conf.get_update_triggers());
+		logger->set_number_of_targets(conf.get_number_target_triggers());
+		logger->activate_logger();
+		logger->track_suite(conf.get_suite_name());
+	}
+	return logger;
+}
+
+void SuiteRunner::run(int const independentRuns){
+	IOHprofiler_configuration conf;
+	conf.readcfg(configFile);
+	std::vector<int> const problems = conf.get_problem_id();
+	std::vector<int> const instances = conf.get_instance_id();
+	std::vector<int> const dimensions = conf.get_dimension();
+	int const tasks = jobs.size() * problems.size() * instances.size() * dimensions.size() * independentRuns;
+
+	ThreadPool pool(threads);
+	pool.parallelForStreams(tasks, [&](int const i){
+		int task = i / independentRuns; // Consecutive tasks are runs of the same problem
+		int const dimension = dimensions[task % dimensions.size()];
+		task /= dimensions.size();
+		int const instance = instances[task % instances.size()];
+		task /= instances.size();
+		int const problemId = problems[task % problems.size()];
+		int const configuration = task / problems.size();
+
+		Problem const problem = loadSuiteProblem(conf.get_suite_name(), problemId, instance, dimension, evaluationThreads);
+
+		int const slot = getThreadSlot();
+		CsvLogger const logger = getLogger(conf, configuration, slot);
+		logger->track_problem(*problem);
+		jobs[configuration](problem, logger, "_t" + std::to_string(slot));
+	});
+
+	loggers.clear(); // Closes the last files
+}
+
+int SuiteRunner::size() const {
+	return jobs.size();
+}
@@ -0,0 +1,94 @@
+#include "threadpool.h"
+#include "rng.h"
+
+ThreadPool::ThreadPool(int const threads)
+	: task(NULL), next(0), n(0), active(0), generation(0), stop(false){
+	for (int i = 1; i < threads; i++)
+		workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool(){
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+	wake.notify_all();
+	for (std::thread& t : workers)
+		t.join();
+}
+
+int ThreadPool::size() const {
+	return workers.size() + 1;
+}
+
+void ThreadPool::work(){
+	int i;
+	while ((i = next++) < n){
+		try {
+			(*task)(i);
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!error)
+				error = std::current_exception();
+		}
+	}
+}
+
+void ThreadPool::workerLoop(){
+	unsigned int seen = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true){
+		wake.wait(lock, [&]{return stop || generation != seen;});
+		if (stop)
+			return;
+		seen = generation;
+
+		lock.unlock();
+		work();
+		lock.lock();
+
+		if (--active == 0)
+			finished.notify_one();
+	}
+}
+
+void ThreadPool::parallelFor(int const n, std::function<void(int const)> const& f){
+	if (workers.empty()){
+		for (int i = 0; i < n; i++)
+			f(i);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		task = &f;
+		this->n = n;
+		next = 0;
+		active = workers.size();
+		error = NULL;
+		generation++;
+	}
+	wake.notify_all();
+	work();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	finished.wait(lock, [&]{return active == 0;});
+	task = NULL;
+	if (error)
+		std::rethrow_exception(error);
+}
+
+void ThreadPool::parallelForStreams(int const n, std::function<void(int const)> const& f){
+	uint64_t const seed = rng.getSeed();
+	uint64_t const epoch = rng.nextSeed();
+	RNG const caller = rng; // The calling thread runs some of the calls, which reseed its rng
+
+	parallelFor(n, [&](int const i){
+		uint64_t stream = epoch + uint64_t(i) * 0x9E3779B97F4A7C15ULL; // SplitMix64 finalizer
+		stream = (stream ^ (stream >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		stream = (stream ^ (stream >> 27)) * 0x94D049BB133111EBULL;
+		rng.seed(seed, stream ^ (stream >> 31));
+		f(i);
+	});
+	rng = caller;
+}
@@ -1,11 +1,15 @@
 #include "topologymanager.h"
 #include "particle.h"
 #include "rng.h"
+#include "checkpoint.h"
 #include <algorithm>
 #include <iostream>
 
 /*		Base 		*/
-TopologyManager::TopologyManager(std::vector<Particle*> const & particles) :particles(particles){}
+TopologyManager::TopologyManager(std::vector<Particle*> const & particles) :particles(particles), graph(particles.size()){
+	for (int i = 0; i < (int)particles.size(); i++)
+		particles[i]->setNeighborhood(Neighborhood(&graph, &particles, i));
+}
 
 #define LC(X) [](std::vector<Particle*> const& p){return new X(p);}
 std::map<std::string, std::function<TopologyManager* (std::vector<Particle*> const&)>> const topologies{
@@ -25,56 +29,52 @@ void TopologyManager::update(double progress){
 	// default: do nothing. (static topologies)
 }
 
+bool TopologyManager::isStatic() const {
+	return true;
+}
+
+bool TopologyManager::isGlobal() const {
+	return false;
+}
+
+NeighborGraph const& TopologyManager::getGraph() const {
+	return graph;
+}
+
+void TopologyManager::save(CheckpointWriter& writer) const {
+	graph.save(writer);
+}
+
+void TopologyManager::load(CheckpointReader& reader){
+	graph.load(reader);
+}
+
 /*		Lbest 		*/
 LbestTopologyManager::LbestTopologyManager(std::vector<Particle*> const & particles)
 	:TopologyManager(particles){
 	int const popSize = particles.size();
 	for (int i = 0; i < popSize; i++){
-		if (i ==0)
-			particles[0]->addNeighbor(particles[popSize-1]);
-		else
-			particles[i]->addNeighbor(particles[i-1]);
-
-		if (i == popSize -1)
-			particles[i]->addNeighbor(particles[0]);
-		else
-			particles[i]->addNeighbor(particles[i+1]);
+		graph.addNeighbor(i, (i + popSize - 1) % popSize);
+		graph.addNeighbor(i, (i + 1) % popSize);
 	}
 }
 
 /*		Gbest 		*/
 GbestTopologyManager::GbestTopologyManager(std::vector<Particle*> const & particles)
 	:TopologyManager(particles){
-	int const popSize = particles.size();
-	for (int i = 0; i < popSize; i++){
-		for (int j = 0; j < popSize; j++){
-			if (i != j){
-				particles[i]->addNeighbor(particles[j]);
-			}
-		}
-	}
+	graph.connectAll();
+}
+
+bool GbestTopologyManager::isGlobal() const {
+	return true;
 }
 
 /*		Random 		*/
 RandomTopologyManager::RandomTopologyManager(std::vector<Particle*> const & particles)
 	:TopologyManager(particles), connections(3){
 	int const popSize = particles.size();
-
-	for (int i = 0; i < popSize; i++){
-		std::vector<int> possibilities;
-		possibilities.reserve(popSize-1);
-		for (int j = 0; j < popSize; j++){
-			if (i != j){
-				possibilities.push_back(j);
-			}
-		}
-
-		for (int j = 0; j < connections; j++){
-			int index = rng.randInt(0,possibilities.size()-1);
-			particles[i]->addNeighbor(particles[possibilities[index]]);
-			possibilities.erase(possibilities.begin() + index);
-		}
-	}
+	for (int i = 0; i < popSize; i++)
+		graph.addRandomNeighbors(i, connections);
 }
 
 /*		Von Neumann		*/
@@ -88,25 +88,11 @@ VonNeumannTopologyManager::VonNeumannTopologyManager(std::vector<Particle*> cons
 
 	for (int i = 0; i < rows; i++){
 		for (int j = 0; j < columns; j++){
-			if (i != rows-1)
-				particles[i * columns + j]->addNeighbor(particles[(i+1) * columns + j]);
-			else 
-				particles[i * columns + j]->addNeighbor(particles[j]);
-
-			if (i != 0)
-				particles[i * columns + j]->addNeighbor(particles[(i-1) * columns + j]);
-			else 
-				particles[i * columns + j]->addNeighbor(particles[(rows-1)* columns + j]);
-
-			if (j != columns-1)
-				particles[i * columns + j]->addNeighbor(particles[i * columns + (j+1)]);
-			else 
-				particles[i * columns + j]->addNeighbor(particles[i * columns + 0]);
-
-			if (j != 0)
-				particles[i * columns + j]->addNeighbor(particles[i * columns + (j-1)]);
-			else 
-				particles[i * columns + j]->addNeighbor(particles[i * columns + (columns -1)]);
+			int const self = i * columns + j;
+			graph.addNeighbor(self, ((i + 1) % rows) * columns + j);
+			graph.addNeighbor(self, ((i + rows - 1) % rows) * columns + j);
+			graph.addNeighbor(self, i * columns + (j + 1) % columns);
+			graph.addNeighbor(self, i * columns + (j + columns - 1) % columns);
 		}
 	}
 }
@@ -116,8 +102,8 @@ WheelTopologyManager::WheelTopologyManager(std::vector<Particle*> const & partic
 	:TopologyManager(particles){
 	int const popSize = particles.size();
 	for (int i = 1; i < popSize; i++){
-		particles[i]->addNeighbor(particles[0]);
-		particles[0]->addNeighbor(particles[i]);
+		graph.addNeighbor(i, 0);
+		graph.addNeighbor(0, i);
 	}
 }
 
@@ -128,15 +114,8 @@ IncreasingTopologyManager::IncreasingTopologyManager(std::vector<Particle*> cons
 
 	int const popSize = particles.size();
 	for (int i = 0; i < popSize; i++){
-		if (i ==0)
-			particles[0]->addNeighbor(particles[popSize-1]);
-		else
-			particles[i]->addNeighbor(particles[i-1]);
-
-		if (i == popSize -1)
-			particles[i]->addNeighbor(particles[0]);
-		else
-			particles[i]->addNeighbor(particles[i+1]);
+		graph.addNeighbor(i, (i + popSize - 1) % popSize);
+		graph.addNeighbor(i, (i + 1) % popSize);
 	}
 }
 
@@ -147,39 +126,35 @@ void IncreasingTopologyManager::update(double progress){
 
 	if (newConnectivity > currentConnectivity){
 		int const newNeighbors = newConnectivity - currentConnectivity;
-		std::vector<Particle*> possibilities;
-
-		for (int i = 0; i < popSize; i++){
-			for (int k = 0; k < popSize; k++){
-				if (k != i && !particles[i]->isNeighbor(particles[k])){
-					possibilities.push_back(particles[k]);
-				}
-			}
-
-			for (int j = 0; j < newNeighbors; j++){
-				int randIndex = rng.randInt(0,possibilities.size()-1);
-				particles[i]->addNeighbor(possibilities[randIndex]);
-				possibilities.erase(possibilities.begin() + randIndex);			
-			}			
-			possibilities.clear();
-			
-		}
+		for (int i = 0; i < popSize; i++)
+			graph.addRandomNeighbors(i, newNeighbors);
 		currentConnectivity = newConnectivity;
 	}
 }
 
+bool IncreasingTopologyManager::isStatic() const {
+	return false;
+}
+
+void IncreasingTopologyManager::save(CheckpointWriter& writer) const {
+	TopologyManager::save(writer);
+	writer.write<int32_t>(currentConnectivity);
+}
+
+void IncreasingTopologyManager::load(CheckpointReader& reader){
+	TopologyManager::load(reader);
+	int32_t connectivity;
+	reader.read(connectivity);
+	currentConnectivity = connectivity;
+}
+
 /* Decreasing connectivity */
 DecreasingTopologyManager::DecreasingTopologyManager(std::vector<Particle*> const & particles)
 	:TopologyManager(particles){
 	int const popSize = particles.size();
 	maxConnectivity = popSize;
 	currentConnectivity = popSize-1;
-	for (int i = 0; i < popSize; i++){
-		for (int j = 0; j < popSize; j++){
-			if (i != j)
-				particles[i]->addNeighbor(particles[j]);
-		}
-	}
+	graph.connectAll();
 }
 
 void DecreasingTopologyManager::update(double progress){
@@ -189,27 +164,32 @@ void DecreasingTopologyManager::update(double progress){
 
 	if (newConnectivity < currentConnectivity){
 		int const removeNeighbors = currentConnectivity - newConnectivity;
-		std::vector<Particle*> possibilities;
-
 		for (int i = 0; i < popSize; i++){
-			for (int k = 0; k < popSize; k++){
-				if (i != k && !(i == 0 && k == popSize-1) && k != i-1  && k != ((i+1)%popSize)
-					&& particles[i]->isNeighbor(particles[k])){
-					possibilities.push_back(particles[k]);
-				}
-			}
-
-			for (int k = 0; k < removeNeighbors; k++){
-				int randIndex = rng.randInt(0,possibilities.size()-1);
-				particles[i]->removeNeighbor(possibilities[randIndex]);
-				possibilities.erase(possibilities.begin() + randIndex);
-			}
-			possibilities.clear();
+			int const prev = (i + popSize - 1) % popSize, next = (i + 1) % popSize;
+			graph.removeRandomNeighbors(i, removeNeighbors, [prev, next](int const k){ // The ring is always kept
+				return k == prev || k == next;
+			});
 		}
 		currentConnectivity = newConnectivity;
 	}
 }
 
+bool DecreasingTopologyManager::isStatic() const {
+	return false;
+}
+
+void DecreasingTopologyManager::save(CheckpointWriter& writer) const {
+	TopologyManager::save(writer);
+	writer.write<int32_t>(currentConnectivity);
+}
+
+void DecreasingTopologyManager::load(CheckpointReader& reader){
+	TopologyManager::load(reader);
+	int32_t connectivity;
+	reader.read(connectivity);
+	currentConnectivity = connectivity;
+}
+
 
 /* Dynamic multi-swarm */
 MultiSwarmTopologyManager::MultiSwarmTopologyManager(std::vector<Particle*> const & ptcs)
@@ -218,41 +198,46 @@ MultiSwarmTopologyManager::MultiSwarmTopologyManager(std::vector<Particle*> cons
 }
 
 void MultiSwarmTopologyManager::createClusters(){
-	std::vector<Particle*> toInitialize = particles;
-
-	while (!toInitialize.empty()){
-		std::vector<Particle*> cluster;
-		int newClusterSize;
-
-		if ((int)toInitialize.size() >= 2 * clusterSize)
-			newClusterSize = clusterSize;
-		else 
-			newClusterSize = toInitialize.size();
-
-		cluster.reserve(newClusterSize);
-		for (int i = 0; i < newClusterSize; i++){
-			int randIndex = rng.randInt(0,toInitialize.size()-1);
-			cluster.push_back(toInitialize[randIndex]);
-			toInitialize.erase(toInitialize.begin() + randIndex);
-		}
-
-		for (int i = 0; i < (int)cluster.size(); i++){
-			for (int j = 0; j < (int)cluster.size(); j++){
+	int const popSize = particles.size();
+	std::vector<int> order(popSize);
+	for (int i = 0; i < popSize; i++)
+		order[i] = i;
+
+	for (int i = popSize - 1; i > 0; i--) // Random clusters are consecutive runs of a shuffled order
+		std::swap(order[i], order[rng.randInt(0, i)]);
+
+	int start = 0;
+	while (start < popSize){
+		int const newClusterSize = popSize - start >= 2 * clusterSize ? clusterSize : popSize - start;
+		for (int i = start; i < start + newClusterSize; i++)
+			for (int j = start; j < start + newClusterSize; j++)
 				if (i != j)
-					cluster[i]->addNeighbor(cluster[j]);
-			}
-		}
-
-		cluster.clear();
+					graph.addNeighbor(order[i], order[j]);
+		start += newClusterSize;
 	}
 }
 
 void MultiSwarmTopologyManager::update(double progress){
 	count++;
 	if (count >= 5){
-		for (Particle* p: particles)
-			p->removeAllNeighbors();
+		graph.removeAllNeighbors();
 		createClusters();
 		count = 0;
 	}
 }
+
+bool MultiSwarmTopologyManager::isStatic() const {
+	return false;
+}
+
+void MultiSwarmTopologyManager::save(CheckpointWriter& writer) const {
+	TopologyManager::save(writer);
+	writer.write<int32_t>(count);
+}
+
+void MultiSwarmTopologyManager::load(CheckpointReader& reader){
+	TopologyManager::load(reader);
+	int32_t generations;
+	reader.read(generations);
+	count = generations;
+}
@@ -0,0 +1,116 @@
+#include <unistd.h>
+#include <algorithm>
+#include "trajectorywriter.h"
+#include "population.h"
+
+namespace {
+	char const magic[8] = {'P', 'S', 'O', 'T', 'R', 'A', 'J', '\0'};
+	uint32_t const version = 2;
+
+	// Whether the trajectory at path has the header up to its first iteration, and a frame for every
+	// recorded iteration before firstIteration. Frames after those are cut off, the resumed run records them again.
+	bool resumable(std::string const path, uint32_t const header[6], int const firstIteration, int64_t const frameBytes){
+		std::ifstream in(path, std::ios::binary | std::ios::ate);
+		if (!in)
+			return false;
+
+		int64_t const bytes = in.tellg();
+		char fileMagic[8];
+		uint32_t fileHeader[6];
+		in.seekg(0);
+		if (!in.read(fileMagic, sizeof(fileMagic)) || !in.read(reinterpret_cast<char*>(fileHeader), sizeof(fileHeader)))
+			return false;
+		if (!std::equal(magic, magic + sizeof(magic), fileMagic) || !std::equal(header, header + 4, fileHeader)
+				|| fileHeader[4] > uint32_t(firstIteration))
+			return false;
+
+		int64_t const frames = (firstIteration - fileHeader[4] + header[3] - 1) / header[3];
+		int64_t const length = sizeof(fileMagic) + sizeof(fileHeader) + frames * frameBytes;
+		return length <= bytes && truncate(path.c_str(), length) == 0;
+	}
+}
+
+TrajectoryWriter::TrajectoryWriter(std::string const filename, int const size, int const D, int const decimation,
+		int const firstIteration)
+	: size(size), D(D), decimation(decimation), iteration(firstIteration), stop(false){
+	uint32_t const first = (firstIteration + decimation - 1) / decimation * decimation; // Of a new trajectory
+	uint32_t const header[6] = {version, uint32_t(size), uint32_t(D), uint32_t(decimation), first, 0};
+	bool const resumes = firstIteration > 0 &&
+		resumable(filename, header, firstIteration, int64_t(size) * (D + 1) * sizeof(float));
+
+	out.open(filename, std::ios::binary | (resumes ? std::ios::app : std::ios::trunc));
+	if (!out) // Nothing is recorded, like the text loggers do if their folder is missing
+		return;
+
+	if (!resumes){
+		out.write(magic, sizeof(magic));
+		out.write(reinterpret_cast<char const*>(header), sizeof(header));
+	}
+
+	frames.resize(framesInFlight, std::vector<float>(size * (D + 1)));
+	for (int i = 0; i < framesInFlight; i++)
+		idle.push_back(i);
+	writer = std::thread(&TrajectoryWriter::writeLoop, this);
+}
+
+TrajectoryWriter::~TrajectoryWriter(){
+	if (!writer.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+	ready.notify_one();
+	writer.join();
+}
+
+void TrajectoryWriter::record(Population const& population){
+	if (!writer.joinable() || iteration++ % decimation != 0)
+		return;
+
+	int frame;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		freed.wait(lock, [this]{return !idle.empty();});
+		frame = idle.back();
+		idle.pop_back();
+	}
+
+	float* row = frames[frame].data();
+	for (int i = 0; i < size; i++){
+		double const* const x = population.getX(i);
+		for (int j = 0; j < D; j++)
+			row[j] = x[j];
+		row[D] = population.getFitness(i);
+		row += D + 1;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		queued.push_back(frame);
+	}
+	ready.notify_one();
+}
+
+void TrajectoryWriter::writeLoop(){
+	while (true){
+		int frame;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			ready.wait(lock, [this]{return stop || !queued.empty();});
+			if (queued.empty()) // Stopped, and every frame is written
+				return;
+			frame = queued.front();
+			queued.pop_front();
+		}
+
+		out.write(reinterpret_cast<char const*>(frames[frame].data()), frames[frame].size() * sizeof(float));
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			idle.push_back(frame);
+		}
+		freed.notify_one();
+	}
+}
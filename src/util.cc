@@ -1,30 +1,58 @@
 #include "util.h"
 #include "rng.h"
+#include "simd.h"
 #include <experimental/filesystem>
 
 void scale(std::vector<double> & vec, double const x){
-	std::transform(vec.begin(), vec.end(), vec.begin(),
-	       std::bind(std::multiplies<double>(), std::placeholders::_1, x));
+	scale(vec.data(), x, vec.size());
 }
 
-void add(std::vector<double>const& lhs, std::vector<double>const& rhs, std::vector<double>& store){
-	std::transform( lhs.begin(), lhs.end(),
-	            rhs.begin(), store.begin(), 
-	            std::plus<double>());
+void add(ConstSpan const lhs, ConstSpan const rhs, std::vector<double>& store){
+	add(lhs.data(), rhs.data(), store.data(), lhs.size());
 }
 
-void subtract(std::vector<double>const& lhs, std::vector<double>const& rhs, std::vector<double>& store){
-	std::transform( lhs.begin(), lhs.end(),
-	                rhs.begin(), store.begin(), 
-	                std::minus<double>());
+void subtract(ConstSpan const lhs, ConstSpan const rhs, std::vector<double>& store){
+	subtract(lhs.data(), rhs.data(), store.data(), lhs.size());
 }
 
 void randomMult(std::vector<double>& vec, double const min, double const max){
-	for (unsigned int i = 0; i < vec.size(); i++){
-		vec[i] *= rng.randDouble(min, max);
+	randomMult(vec.data(), min, max, vec.size());
+}
+
+void scale(double* const vec, double const x, int const D){
+	getVectorKernels(D)->scale(vec, x, D);
+}
+
+void add(double const* const lhs, double const* const rhs, double* const store, int const D){
+	getVectorKernels(D)->add(lhs, rhs, store, D);
+}
+
+void subtract(double const* const lhs, double const* const rhs, double* const store, int const D){
+	getVectorKernels(D)->subtract(lhs, rhs, store, D);
+}
+
+void randomMult(double* const vec, double const min, double const max, int const D){
+	double r[64];
+	for (int start = 0; start < D; start += 64){
+		int const n = std::min(64, D - start);
+		rng.fillUniform(r, n, min, max);
+		getVectorKernels(n)->multiply(vec + start, r, n);
 	}
 }
 
+void addScaledDifference(ConstSpan const a, ConstSpan const b, ConstSpan const c, double const F, double* const store){
+	getVectorKernels(a.size())->addScaledDifference(a.data(), b.data(), c.data(), F, store, a.size());
+}
+
+void addScaledDifferences(ConstSpan const a, ConstSpan const b, ConstSpan const c, ConstSpan const d, ConstSpan const e,
+		double const F, double* const store){
+	getVectorKernels(a.size())->addScaledDifferences(a.data(), b.data(), c.data(), d.data(), e.data(), F, store, a.size());
+}
+
+void addScaledDifferences(ConstSpan const a, ConstSpan const b, ConstSpan const c, ConstSpan const d, ConstSpan const e,
+		ConstSpan const f, ConstSpan const g, double const F, double* const store){
+	getVectorKernels(a.size())->addScaledDifferences3(a.data(), b.data(), c.data(), d.data(), e.data(), f.data(), g.data(), F, store, a.size());
+}
 
 bool comparePtrs(Solution const* const a, Solution const *const b){
 	return *a < *b;
@@ -56,11 +84,7 @@ void printVec(std::vector<double> const v){
 }
 
 double distance(Solution const*const s1, Solution const*const s2) {
-	double d=0;
-	for (int i = 0; i < s1->D; i++){
-		d += std::pow(s1->getX(i) - s2->getX(i), 2.); 
-	}
-	return std::sqrt(d);
+	return std::sqrt(getVectorKernels(s1->D)->squaredDistance(s1->getXView().data(), s2->getXView().data(), s1->D));
 }
 
 std::string checkFilename(std::string const fn){
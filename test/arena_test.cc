@@ -0,0 +1,65 @@
+#include <IOHprofiler_experimenter.h>
+#include "check.h"
+#include "desuite.h"
+#include "psode2.h"
+#include "rng.h"
+
+// Reusing the donor and trial buffers of a generation must not change a run: for the same seed,
+// DE and PSODE2 with and without the arena evaluate the same positions in the same order.
+
+int const D = 5;
+
+class TracedSphere : public IOHprofiler_problem<double> {
+	public:
+		std::vector<double> trace; // Every objective value, in order of evaluation
+
+		TracedSphere(){
+			IOHprofiler_set_problem_name("traced sphere");
+			IOHprofiler_set_number_of_objectives(1);
+			IOHprofiler_set_lowerbound(std::vector<double>(D, -5.));
+			IOHprofiler_set_upperbound(std::vector<double>(D, 5.));
+			IOHprofiler_set_number_of_variables(D);
+			IOHprofiler_set_as_minimization();
+			IOHprofiler_set_optimal(0.);
+		}
+
+		double internal_evaluate(std::vector<double> const& x){
+			double y = 0.;
+			for (double const xi : x)
+				y += (xi - 1.) * (xi - 1.);
+			trace.push_back(y);
+			return y;
+		}
+};
+
+template <typename Algorithm, typename Run>
+std::vector<double> trace(Algorithm algorithm, bool const useArena, Run const run){
+	rng.seed(42, 0);
+	std::shared_ptr<TracedSphere> const problem = std::make_shared<TracedSphere>();
+	algorithm.setArena(useArena);
+	run(algorithm, problem);
+	return problem->trace;
+}
+
+int main(){
+	enterScratchDirectory();
+	std::shared_ptr<IOHprofiler_csv_logger> const logger = std::make_shared<IOHprofiler_csv_logger>();
+
+	DESuite suite;
+	for (int i = 0; i < suite.size(); i += 37){
+		auto const run = [&](DifferentialEvolution& de, std::shared_ptr<TracedSphere> const problem){
+			de.run(problem, logger, 1000 * D, 5 * D);
+		};
+		DifferentialEvolution const de = suite.getDE(i);
+		check(trace(de, true, run) == trace(de, false, run), de.getIdString() + ": evaluations");
+	}
+
+	for (std::string const topology : {"L", "G", "D"}){
+		auto const run = [&](PSODE2& hybrid, std::shared_ptr<TracedSphere> const problem){
+			hybrid.run(problem, logger, 1000 * D, 10 * D, {});
+		};
+		PSODE2 const hybrid(HybridConfig("I", topology, "RS", "A", "B1", "B", "J", "RS"));
+		check(trace(hybrid, true, run) == trace(hybrid, false, run), hybrid.getIdString() + ": evaluations");
+	}
+	return failures();
+}
@@ -0,0 +1,38 @@
+#include <IOHprofiler_experimenter.h>
+#include "check.h"
+#include "batchproblem.h"
+#include "desuite.h"
+#include "rng.h"
+
+// DE evaluating its trial populations on several threads must make the same run as DE
+// evaluating them serially: same parameters per generation, same result, same evaluations.
+
+int const D = 5;
+int const threads = 4;
+
+int run(DifferentialEvolution de, int const evaluationThreads, std::string const logSuffix){
+	rng.seed(42, 0);
+	std::shared_ptr<IOHprofiler_problem<double>> const problem = loadSuiteProblem("BBOB", 1, 1, D, evaluationThreads);
+	check(bool(std::dynamic_pointer_cast<BatchProblem>(problem)) == (evaluationThreads > 1), "suite problems evaluated on threads are batch problems");
+	de.setEvaluationThreads(evaluationThreads);
+	de.setLogSuffix(logSuffix);
+	de.run(problem, std::make_shared<IOHprofiler_csv_logger>(), 1000 * D, 5 * D);
+	return problem->IOHprofiler_get_evaluations();
+}
+
+int main(){
+	enterScratchDirectory();
+	DESuite suite;
+	for (int i = 0; i < suite.size(); i += 101){
+		DifferentialEvolution const de = suite.getDE(i);
+		std::string const name = de.getIdString();
+		int const serialEvaluations = run(de, 1, "_serial");
+		int const threadedEvaluations = run(de, threads, "_threaded");
+
+		check(serialEvaluations == threadedEvaluations, name + ": evaluations");
+		for (std::string const extension : {".dat", ".par"})
+			check(readFile("scratch/extra_data/" + name + "_serial" + extension) ==
+				readFile("scratch/extra_data/" + name + "_threaded" + extension), name + ": " + extension + " file");
+	}
+	return failures();
+}
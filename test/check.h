@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Minimal support for the tests in this folder: every test is a program whose main returns
+// failures(), so make test stops at the first one with a failed check.
+
+inline int& failures(){
+	static int count = 0;
+	return count;
+}
+
+inline void check(bool const condition, std::string const what){
+	if (!condition){
+		std::cerr << "FAILED: " << what << std::endl;
+		failures()++;
+	}
+}
+
+// Moves into a fresh temporary folder with the scratch folders the algorithms write to
+inline void enterScratchDirectory(){
+	char path[] = "/tmp/pso-de-test-XXXXXX";
+	if (!mkdtemp(path) || chdir(path) != 0){
+		std::cerr << "Could not create a temporary folder" << std::endl;
+		std::exit(1);
+	}
+	mkdir("scratch", 0755);
+	mkdir("scratch/extra_data", 0755);
+	mkdir("scratch/animations", 0755);
+}
+
+inline std::string readFile(std::string const path){
+	std::ifstream in(path);
+	std::stringstream contents;
+	contents << in.rdbuf();
+	return contents.str();
+}
@@ -0,0 +1,113 @@
+#include <IOHprofiler_experimenter.h>
+#include <cstdio>
+#include "check.h"
+#include "differentialevolution.h"
+#include "particleswarm.h"
+#include "psode2.h"
+#include "rng.h"
+
+// A run that is preempted and resumed from its last checkpoint must evaluate the same positions
+// as the run without interruption: the resumed run continues where the checkpoint was taken, and
+// the preempted run has already done the evaluations before it.
+
+int const D = 5;
+int const budget = 300 * D;
+std::string const checkpointFile = "checkpoint.bin";
+
+struct Preempted {};
+
+// Records every evaluated position and value, and preempts the run after a number of evaluations
+class RecordedSphere : public IOHprofiler_problem<double> {
+	private:
+		int const limit; // Evaluations before the preemption, -1 for none
+	public:
+		std::vector<double> trace; // The positions and values of all evaluations, in order
+
+		RecordedSphere(int const limit): limit(limit){
+			IOHprofiler_set_problem_name("recorded sphere");
+			IOHprofiler_set_number_of_objectives(1);
+			IOHprofiler_set_lowerbound(std::vector<double>(D, -5.));
+			IOHprofiler_set_upperbound(std::vector<double>(D, 5.));
+			IOHprofiler_set_number_of_variables(D);
+			IOHprofiler_set_as_minimization();
+			IOHprofiler_set_optimal(0.);
+		}
+
+		double internal_evaluate(std::vector<double> const& x){
+			if (int(trace.size()) == limit * (D + 1))
+				throw Preempted();
+
+			double y = 0.;
+			for (double const xi : x)
+				y += (xi - 3.9) * (xi - 3.9); // Near the bound, so the constraint handlers are used
+			trace.insert(trace.end(), x.begin(), x.end());
+			trace.push_back(y);
+			return y;
+		}
+};
+
+// run(problem, interval) runs the algorithm, with checkpoints every interval iterations if interval > 0
+template <typename Run>
+void testResume(std::string const name, Run const run){
+	std::shared_ptr<IOHprofiler_csv_logger> const logger = std::make_shared<IOHprofiler_csv_logger>();
+	std::remove(checkpointFile.c_str());
+
+	rng.seed(42, 0);
+	std::shared_ptr<RecordedSphere> const full = std::make_shared<RecordedSphere>(-1);
+	run(full, logger, 0);
+
+	rng.seed(42, 0);
+	std::shared_ptr<RecordedSphere> const preempted = std::make_shared<RecordedSphere>(budget * 6 / 10);
+	try {
+		run(preempted, logger, 3);
+		check(false, name + ": preempted");
+	} catch (Preempted const&){}
+
+	rng.seed(42, 1); // The checkpoint holds the rng state
+	std::shared_ptr<RecordedSphere> const resumed = std::make_shared<RecordedSphere>(-1);
+	run(resumed, logger, 3);
+
+	std::vector<double> const& a = full->trace;
+	std::vector<double> const& b = preempted->trace;
+	std::vector<double> const& c = resumed->trace;
+	size_t const before = a.size() - c.size(); // Evaluations of the full run before the checkpoint
+	check(c.size() < a.size() && before <= b.size(), name + ": resumed from a checkpoint");
+	check(c.size() <= a.size() && std::equal(c.begin(), c.end(), a.end() - c.size()), name + ": resumed run continues the full run");
+	check(before <= b.size() && std::equal(a.begin(), a.begin() + before, b.begin()), name + ": preempted run starts like the full run");
+	check(!std::ifstream(checkpointFile), name + ": checkpoint removed at the end");
+}
+
+int main(){
+	enterScratchDirectory();
+	typedef std::shared_ptr<RecordedSphere> const Problem;
+	typedef std::shared_ptr<IOHprofiler_csv_logger> const Logger;
+
+	for (std::string const mutation : {"R1", "PX", "TR"})
+		for (std::string const adaptation : {"S", "J", "N"})
+			for (std::string const repair : {"RS", "RC", "MB"})
+				testResume("DE " + mutation + adaptation + repair, [&](Problem problem, Logger logger, int const interval){
+					DifferentialEvolution de(DEConfig(mutation, "B", adaptation, repair));
+					if (interval > 0)
+						de.setCheckpoint(checkpointFile, interval);
+					de.run(problem, logger, budget, 20);
+				});
+
+	for (std::string const topology : {"L", "G", "D"})
+		for (std::string const synchronicity : {"A", "S"})
+			for (std::string const repair : {"RS", "RC"})
+				testResume("PSO " + topology + synchronicity + repair, [&](Problem problem, Logger logger, int const interval){
+					ParticleSwarm pso(PSOConfig("I", topology, repair, synchronicity));
+					if (interval > 0)
+						pso.setCheckpoint(checkpointFile, interval);
+					pso.run(problem, logger, budget, 20, {});
+				});
+
+	for (std::string const topology : {"L", "G"})
+		testResume("PSODE2 " + topology, [&](Problem problem, Logger logger, int const interval){
+			PSODE2 hybrid(HybridConfig("I", topology, "RS", "A", "P1", "B", "J", "RC"));
+			if (interval > 0)
+				hybrid.setCheckpoint(checkpointFile, interval);
+			hybrid.run(problem, logger, budget, 20, {});
+		});
+	return failures();
+}
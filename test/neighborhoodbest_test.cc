@@ -0,0 +1,64 @@
+#include <limits>
+#include "check.h"
+#include "neighborhoodbest.h"
+#include "population.h"
+#include "topologymanager.h"
+#include "threadpool.h"
+#include "rng.h"
+
+// NeighborhoodBest must give every particle the best personal best its neighborhood (the particle
+// and its neighbors) has had, with its position, serially and on a pool, for every topology.
+
+int const D = 3;
+int const size = 20;
+int const iterations = 10;
+
+void test(std::string const topology, ThreadPool* const pool){
+	std::vector<double> const lowerBound(D, -5.), upperBound(D, 5.);
+	PSOConstraintHandler* const psoCH = psoCHs.at("RS")(lowerBound, upperBound);
+	ParticleUpdateSettings const settings("I", {}, psoCH);
+	Population population(size, D, &settings);
+	std::vector<Particle*> const& particles = population.getParticles();
+	TopologyManager* const topologyManager = topologies.at(topology)(particles);
+	NeighborhoodBest neighborhoodBest(population, *topologyManager);
+
+	std::vector<double> expected(size, std::numeric_limits<double>::max());
+	std::vector<std::vector<double>> expectedPosition(size);
+	std::string const name = topology + (pool ? " on a pool" : "");
+	for (int iteration = 0; iteration < iterations; iteration++){
+		population.randomize(lowerBound, upperBound);
+		for (Particle* const p : particles){
+			p->setFitness(rng.randDouble(0., 1.));
+			p->updatePbest();
+		}
+		neighborhoodBest.update(pool);
+
+		for (int i = 0; i < size; i++){
+			auto const consider = [&](int const j){
+				if (population.getPbest(j) < expected[i]){
+					expected[i] = population.getPbest(j);
+					expectedPosition[i] = particles[j]->getP();
+				}
+			};
+			consider(i);
+			topologyManager->getGraph().forEachNeighbor(i, consider);
+
+			check(particles[i]->getGbest() == expected[i], name + ": neighborhood best of particle " + std::to_string(i));
+			check(particles[i]->getG() == expectedPosition[i], name + ": position of the neighborhood best of particle " + std::to_string(i));
+		}
+		topologyManager->update(double(iteration + 1) / iterations);
+	}
+
+	delete topologyManager;
+	delete psoCH;
+}
+
+int main(){
+	rng.seed(42, 0);
+	ThreadPool pool(4);
+	for (auto const& topology : topologies){
+		test(topology.first, NULL);
+		test(topology.first, &pool);
+	}
+	return failures();
+}
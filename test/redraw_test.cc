@@ -0,0 +1,63 @@
+#include <vector>
+#include "check.h"
+#include "repairhandler.h"
+
+// redrawViolations with per-coordinate resampling: only the infeasible coordinates are redrawn,
+// at most 2D of them per solution, after which the remaining violations are projected onto the
+// bounds. The resample histogram counts the rounds of redraws per solution.
+
+int const D = 6;
+
+struct Redraws {
+	std::vector<std::vector<int>> rounds; // The coordinates of every redraw
+	int coordinates() const {
+		int count = 0;
+		for (std::vector<int> const& round : rounds)
+			count += round.size();
+		return count;
+	}
+};
+
+// Redraws x with the values of draw, one per redraw round, as long as there are any
+template <typename Draw>
+Redraws redraw(DimensionResamplingRepair& repair, double* const x, Draw draw){
+	Redraws redraws;
+	std::vector<int> lanes(D);
+	redrawViolations(repair, x, lanes.data(), [&](Lanes const redrawn){
+		std::vector<int> round;
+		redrawn.forEach(D, [&](int const j){
+			round.push_back(j);
+			x[j] = draw(redraws.rounds.size(), j);
+		});
+		redraws.rounds.push_back(round);
+	});
+	return redraws;
+}
+
+int main(){
+	DimensionResamplingRepair repair(std::vector<double>(D, -1.), std::vector<double>(D, 1.));
+
+	double feasible[D] = {0., 0.5, -0.5, 1., -1., 0.9};
+	check(redraw(repair, feasible, [](int, int){return 0.;}).rounds.empty(), "feasible solutions are not redrawn");
+
+	// Coordinate 1 becomes feasible in the first round, 3 and 5 in the second
+	double x[D] = {0., 2., -0.5, -3., 0.9, 5.};
+	Redraws const fixed = redraw(repair, x, [](int const round, int const j){return round == 0 && j != 1 ? 7. : 0.5;});
+	check(fixed.rounds.size() == 2, "two rounds of redraws");
+	check(fixed.rounds[0] == std::vector<int>({1, 3, 5}), "the first round redraws the infeasible coordinates, in order");
+	check(fixed.rounds[1] == std::vector<int>({3, 5}), "the second round redraws the coordinates that are still infeasible");
+	check(std::vector<double>(x, x + D) == std::vector<double>({0., 0.5, -0.5, 0.5, 0.9, 0.5}), "feasible coordinates keep their value");
+
+	// Never feasible: the budget of 2D coordinates runs out, then the rest is projected
+	double y[D] = {9., -9., 9., 0., 9., -9.};
+	Redraws const exhausted = redraw(repair, y, [](int, int const j){return j % 2 ? -9. : 9.;});
+	check(exhausted.coordinates() == 2 * D, "at most 2D coordinates are redrawn");
+	check(exhausted.rounds.back() == std::vector<int>({0, 1}), "the last round redraws the first coordinates the budget covers");
+	check(std::vector<double>(y, y + D) == std::vector<double>({1., -1., 1., 0., 1., -1.}), "remaining violations are projected");
+
+	std::vector<int> const histogram = repair.takeResampleHistogram();
+	check(histogram.size() == 4 && histogram[0] == 1 && histogram[2] == 1 && histogram[3] == 1,
+		"the histogram counts the rounds of redraws per solution");
+	check(repair.getCorrections() == 2, "corrections count the infeasible solutions");
+	return failures();
+}
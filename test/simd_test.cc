@@ -0,0 +1,98 @@
+#include <cstring>
+#include <random>
+#include <vector>
+#include "check.h"
+#include "simd.h"
+
+// The AVX2 and AVX-512 tables must give bit-identical results to the scalar table, for the
+// dimensions with specialized tables and for others, whose loops end in a partial vector.
+
+int const dimensions[] = {2, 5, 10, 20, 40, 100, 7, 67};
+int const rows = 8; // Inputs per call, e.g. the personal bests of the fully informed update
+
+struct Inputs {
+	std::vector<std::vector<double>> x;
+	std::vector<double const*> p;
+	std::vector<double> lb, ub, phi;
+	std::vector<uint64_t> mask;
+
+	Inputs(int const D): x(rows, std::vector<double>(D)), lb(D, -1.), ub(D, 1.), phi(rows), mask((D + 63) / 64){
+		std::mt19937_64 gen(D);
+		std::uniform_real_distribution<double> dist(-2., 2.);
+		for (std::vector<double>& row : x){
+			for (double& value : row)
+				value = dist(gen);
+			p.push_back(row.data());
+		}
+		for (double& value : phi)
+			value = dist(gen);
+		for (uint64_t& word : mask)
+			word = gen();
+	}
+};
+
+bool same(std::vector<double> const& a, std::vector<double> const& b){
+	return std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0;
+}
+
+// Calls f with the kernels of the ISA and of the scalar table, each on a copy of out, and compares the results
+template <typename F>
+void compare(VectorKernels const& kernels, VectorKernels const& scalar, std::vector<double> const& out, std::string const what, F f){
+	std::vector<double> expected = out, actual = out;
+	f(scalar, expected.data());
+	f(kernels, actual.data());
+	check(same(expected, actual), std::string(kernels.name) + " " + what + " D=" + std::to_string(out.size()));
+}
+
+void test(std::string const isa, int const D){
+	setVectorKernels("scalar");
+	VectorKernels const& scalar = *getVectorKernels(D);
+	setVectorKernels(isa);
+	VectorKernels const& kernels = *getVectorKernels(D);
+
+	Inputs const in(D);
+	std::vector<std::vector<double>> const& x = in.x;
+	double const F = 0.7, w = 0.72, c = 0.9;
+	compare(kernels, scalar, x[0], "scale", [&](VectorKernels const& k, double* const out){k.scale(out, F, D);});
+	compare(kernels, scalar, x[0], "add", [&](VectorKernels const& k, double* const out){k.add(x[1].data(), x[2].data(), out, D);});
+	compare(kernels, scalar, x[0], "subtract", [&](VectorKernels const& k, double* const out){k.subtract(x[1].data(), x[2].data(), out, D);});
+	compare(kernels, scalar, x[0], "multiply", [&](VectorKernels const& k, double* const out){k.multiply(out, x[1].data(), D);});
+	compare(kernels, scalar, x[0], "squaredDistance", [&](VectorKernels const& k, double* const out){
+		out[0] = k.squaredDistance(x[1].data(), x[2].data(), D);
+	});
+	compare(kernels, scalar, x[0], "addScaledDifference", [&](VectorKernels const& k, double* const out){
+		k.addScaledDifference(x[1].data(), x[2].data(), x[3].data(), F, out, D);
+	});
+	compare(kernels, scalar, x[0], "addScaledDifferences", [&](VectorKernels const& k, double* const out){
+		k.addScaledDifferences(x[1].data(), x[2].data(), x[3].data(), x[4].data(), x[5].data(), F, out, D);
+	});
+	compare(kernels, scalar, x[0], "addScaledDifferences3", [&](VectorKernels const& k, double* const out){
+		k.addScaledDifferences3(x[1].data(), x[2].data(), x[3].data(), x[4].data(), x[5].data(), x[6].data(), x[7].data(), F, out, D);
+	});
+	if (D <= 64)
+		compare(kernels, scalar, x[0], "boundViolations", [&](VectorKernels const& k, double* const out){
+			uint64_t const violations = k.boundViolations(x[1].data(), in.lb.data(), in.ub.data(), D);
+			std::memcpy(out, &violations, sizeof(violations));
+		});
+	compare(kernels, scalar, x[0], "select", [&](VectorKernels const& k, double* const out){
+		k.select(x[1].data(), x[2].data(), in.mask.data(), out, D);
+	});
+	compare(kernels, scalar, x[0], "updateVelocity", [&](VectorKernels const& k, double* const out){
+		k.updateVelocity(out, x[1].data(), x[2].data(), x[3].data(), x[4].data(), x[5].data(), w, c, D);
+	});
+	compare(kernels, scalar, x[0], "fullyInformedVelocity", [&](VectorKernels const& k, double* const out){
+		k.fullyInformedVelocity(out, x[1].data(), in.p.data(), in.phi.data(), rows, c, D);
+	});
+}
+
+int main(){
+	for (std::string const isa : {"avx2", "avx512"}){
+		if (!setVectorKernels(isa)){
+			std::cerr << "Skipping " << isa << ", which the CPU does not support" << std::endl;
+			continue;
+		}
+		for (int const D : dimensions)
+			test(isa, D);
+	}
+	return failures();
+}
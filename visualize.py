@@ -1,8 +1,35 @@
 import matplotlib.pyplot as plt 
 import matplotlib.animation as animation 
 from mpl_toolkits.mplot3d import Axes3D
+import numpy as np
+import os
 import sys
 
+HEADER_BYTES = 32
+
+def read_trajectory(path):
+	"""Maps a .trj file written by TrajectoryWriter. Returns the frames as a
+	(frames, population size, D+1) float32 array, positions first and the
+	fitness last, the iteration of the first frame and the number of
+	iterations per frame. Frames are only
+	read from disk when they are accessed, and an incomplete last frame of a
+	trajectory that is still being written is left out."""
+	header = np.fromfile(path, dtype=np.uint8, count=HEADER_BYTES)
+	if header[:8].tobytes() != b'PSOTRAJ\0':
+		sys.exit(path + " is not a trajectory")
+	version, size, D, decimation, first = header[8:28].view('<u4')
+	if version != 2:
+		sys.exit(path + " has unsupported trajectory version " + str(version))
+
+	frame_bytes = int(size) * (int(D) + 1) * 4
+	frames = (os.path.getsize(path) - HEADER_BYTES) // frame_bytes
+	data = np.memmap(path, dtype='<f4', mode='r', offset=HEADER_BYTES, shape=(frames, int(size), int(D) + 1))
+	return data, int(first), int(decimation)
+
+if len(sys.argv) != 2:
+	sys.exit("Usage: python visualize.py scratch/animations/<run>.trj")
+trajectory, first, decimation = read_trajectory(sys.argv[1])
+
 fig = plt.figure() 
 ax = fig.add_subplot(1,1,1, projection='3d')
 ax.set_xlim3d([-5, 5])
@@ -25,24 +52,16 @@ def init():
 # animation function 
 def animate(i): 
 	angle = i % 360
-	xdata, ydata, zdata = [], [], []
-	inp = sys.stdin.readline()
-	if len(inp) == 0:
+	if i >= len(trajectory):
 		anim.event_source.stop()
+		return sc
 
-	inp = inp.rstrip()
-	while inp != "":
-		x,y,z = [ float(x) for x in inp.split() ][:-1][:3]
-		xdata.append(x) 
-		ydata.append(y) 
-		zdata.append(z) 
-		inp = sys.stdin.readline().rstrip()
-
+	frame = trajectory[i]
 	ax.view_init(30, int(angle))
-	sc._offsets3d = (xdata, ydata, zdata)
+	sc._offsets3d = (frame[:, 0], frame[:, 1], frame[:, 2])
 	return sc 
 	
 # plt.axis('off') 
-anim = animation.FuncAnimation(fig, animate, init_func=init) 
+anim = animation.FuncAnimation(fig, animate, init_func=init, frames=len(trajectory)) 
 anim.save('animation.mp4', writer=writer, dpi=500)
 # plt.show()